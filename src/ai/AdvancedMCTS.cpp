@@ -1,59 +1,64 @@
+#include <algorithm>
+
 #include "AdvancedMCTS.h"
 
-AdvancedMCTS::AdvancedMCTS(NeuralNetwork* neuralNetwork, const unsigned int simulations) : MCTS(simulations), neuralNetwork(neuralNetwork) {
+template <unsigned int SIDE_LENGTH>
+AdvancedMCTS<SIDE_LENGTH>::AdvancedMCTS(NeuralNetwork<SIDE_LENGTH>* neuralNetwork, const unsigned int simulations) : MCTS<SIDE_LENGTH>(simulations), neuralNetwork(neuralNetwork) {
 }
 
-float AdvancedMCTS::getMoveValue(const GameState* gameState) {
-	auto const gameStateIter = stateInfos.find(gameState);
-	if (gameStateIter != stateInfos.end()) {
-		return gameStateIter->second.totalValue / gameStateIter->second.visits;
+template <unsigned int SIDE_LENGTH>
+float AdvancedMCTS<SIDE_LENGTH>::getMoveValue(const GameState<SIDE_LENGTH>* gameState) {
+	float visits;
+	float totalValue;
+	if (tree.getStatistics(gameState, visits, totalValue)) {
+		return totalValue / visits;
 	}
 	
 	return -3;
 }
 
-std::vector<float> AdvancedMCTS::getMoveProbabilities(GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+std::vector<float> AdvancedMCTS<SIDE_LENGTH>::getMoveProbabilities(GameState<SIDE_LENGTH>* gameState) {
 	addDirichletNoise(gameState);
 	runSimulations(gameState);
+	const typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
 
 	float totalSimulations = 1;
-	if (stateInfos.find(gameState) != stateInfos.end()) {
-		totalSimulations = stateInfos.at(gameState).visits;
+	if (tree.rootVisits > 0) {
+		totalSimulations = tree.rootVisits;
 	}
 
 	std::vector<float> newMoveProbabilities;
-	newMoveProbabilities.resize(NUM_MOVES);
-	for (unsigned int i = 0; i < NUM_MOVES; i++) {
+	newMoveProbabilities.resize(NUM_MOVES<SIDE_LENGTH>);
+	for (unsigned int i = 0; i < NUM_MOVES<SIDE_LENGTH>; i++) {
 		newMoveProbabilities[i] = 0;
 	}
 
-	for (unsigned int i = 0; i < gameState->getValidMoves()->size(); i++) {
-		auto const childStateIter = stateInfos.find(gameState->getChild(i));
-		if (childStateIter != stateInfos.end()) {
-			newMoveProbabilities[gameState->getValidMoves()->at(i) + 1] = childStateIter->second.visits / totalSimulations;
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		if (root->visits[i] > 0) {
+			newMoveProbabilities[gameState->getValidMoves()->at(i) + 1] = root->visits[i] / totalSimulations;
 		}
 	}
 
 	return newMoveProbabilities;
 }
 
-unsigned int AdvancedMCTS::getBestMove(GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+unsigned int AdvancedMCTS<SIDE_LENGTH>::getBestMove(GameState<SIDE_LENGTH>* gameState) {
 	runSimulations(gameState);
+	const typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
 
 	float totalSimulations = 1;
-	if (stateInfos.find(gameState) != stateInfos.end()) {
-		totalSimulations = stateInfos.at(gameState).visits;
+	if (tree.rootVisits > 0) {
+		totalSimulations = tree.rootVisits;
 	}
 	
 	unsigned int bestMove = 0;
 	float mostVisits = -1;
 	for (unsigned int i = 0; i < gameState->getValidMoves()->size(); i++) {
-		float visits;
-		auto const childStateIter = stateInfos.find(gameState->getChild(i));
-		if (childStateIter != stateInfos.end()) {
-			visits = childStateIter->second.visits / totalSimulations;
-		} else {
-			visits = 0;
+		float visits = 0;
+		if (i < root->childCount) {
+			visits = root->visits[i] / totalSimulations;
 		}
 
 		if (visits > mostVisits) {
@@ -65,97 +70,313 @@ unsigned int AdvancedMCTS::getBestMove(GameState* gameState) {
 	return bestMove;
 }
 
-void AdvancedMCTS::reset() {
-	stateInfos.clear();
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::setTranspositionTableSize(const unsigned int size) {
+	if (size == 0) {
+		transpositions = nullptr;
+	} else {
+		transpositions = std::make_unique<TranspositionTable<SIDE_LENGTH>>(size, true);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::advance(const unsigned int moveNum) {
+	tree.advance(moveNum);
 }
 
-float AdvancedMCTS::simulate(GameState* potentialLeaf) {
-	float value = -1;
-	
-	auto leafStateInfoIter = stateInfos.find(potentialLeaf);
-	const float endState = potentialLeaf->getEndState();
-	if (leafStateInfoIter == stateInfos.end()) {
-		//Evaluates leaf
-		const std::pair<std::vector<float>, float> result = neuralNetwork->predict(potentialLeaf);
-		value = result.second;
-
-		StateInfo stateInfo;
-		stateInfo.validMoveProbabilities = result.first;
-		leafStateInfoIter = stateInfos.emplace(potentialLeaf, stateInfo).first;
-	} else if (endState >= -1) {
-		value = endState;
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::reset() {
+	tree.clear();
+	if (transpositions != nullptr) {
+		transpositions->clear();
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::setBatchSize(const unsigned int batchSize) {
+	if (batchSize < 1) {
+		this->batchSize = 1;
+	} else {
+		this->batchSize = batchSize;
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+float AdvancedMCTS<SIDE_LENGTH>::simulate(typename SearchTree<SIDE_LENGTH>::Node* root) {
+	//Reuses one path buffer per thread so simulations do not allocate
+	thread_local std::vector<PathStep> path;
+	const std::chrono::steady_clock::time_point selectionStart = std::chrono::steady_clock::now();
+	typename SearchTree<SIDE_LENGTH>::Node* leaf = selectLeaf(root, path);
+	const std::chrono::steady_clock::time_point evaluationStart = std::chrono::steady_clock::now();
+
+	float value;
+	if (needsEvaluation(leaf, path)) {
+		//Evaluates leaf, reusing what other move orders found for the same position
+		unsigned int symmetry = 0;
+		const uint64_t key = transpositions != nullptr ? TranspositionTable<SIDE_LENGTH>::getKey(leaf->gameState, symmetry) : 0;
+		std::vector<float> probabilities;
+		const bool transposed = evaluateTransposition(key, symmetry, probabilities, value);
+		if (transpositions != nullptr) {
+			this->recordTransposition(transposed);
+		}
+		if (!transposed) {
+			std::pair<std::vector<float>, float> result = neuralNetwork->predict(leaf->gameState);
+			probabilities = std::move(result.first);
+			value = result.second;
+			if (transpositions != nullptr) {
+				transpositions->storeEvaluation(key, symmetry, probabilities, value);
+			}
+		}
+		tree.expand(leaf, probabilities);
 	} else {
-		//Selects child to explore
-		float bestSelectionScore = -1;
-		unsigned int bestSelection = 0;
-		for (unsigned int i = 0; i < potentialLeaf->getValidMoves()->size(); i++) {
-			float selectionScore;
-
-			auto childStateInfoIter = stateInfos.find(potentialLeaf->getChild(i));
-			if (childStateInfoIter != stateInfos.end()) {
-				//Child value ranges from 0 to 1
-				float childValue;
-				if (potentialLeaf->getColor() == 'O') {
-					childValue = (1 + (childStateInfoIter->second.totalValue / childStateInfoIter->second.visits)) / 2;
-				} else {
-					childValue = (1 - (childStateInfoIter->second.totalValue / childStateInfoIter->second.visits)) / 2;
-				}
-
-
-				
-				//Uses PUCT
-				selectionScore = childValue + EXPLORATION_PARAMETER * leafStateInfoIter->second.validMoveProbabilities.at(i) * sqrtf(leafStateInfoIter->second.visits + 1) / (childStateInfoIter->second.visits + 1);
+		value = leaf->gameState->getEndState();
+	}
+	const std::chrono::steady_clock::time_point evaluationEnd = std::chrono::steady_clock::now();
+
+	backup(root, path, value);
+	this->recordSimulation(static_cast<unsigned int>(path.size()), evaluationStart - selectionStart, evaluationEnd - evaluationStart);
+
+	return value;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool AdvancedMCTS<SIDE_LENGTH>::evaluateTransposition(const uint64_t key, const unsigned int symmetry, std::vector<float>& probabilities, float& value) const {
+	if (transpositions == nullptr || !transpositions->getEvaluation(key, symmetry, probabilities, value)) {
+		return false;
+	}
+
+	float visits;
+	float totalValue;
+	if (transpositions->getStatistics(key, visits, totalValue)) {
+		value = totalValue / visits;
+	}
+
+	return true;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int AdvancedMCTS<SIDE_LENGTH>::selectChild(const typename SearchTree<SIDE_LENGTH>::Node* node, const float parentVisits) const {
+	//Virtual losses count as visits the current player lost
+	const float lossValue = node->gameState->getColor() == 'O' ? -1.0f : 1.0f;
+
+	float bestSelectionScore = -1;
+	unsigned int bestSelection = 0;
+	for (unsigned int i = 0; i < node->childCount; i++) {
+		float selectionScore;
+
+		const unsigned int virtualLosses = node->virtualLosses[i];
+		const unsigned int childVisits = node->visits[i] + virtualLosses;
+		if (childVisits > 0) {
+			const float childTotalValue = node->totalValues[i] + lossValue * static_cast<float>(virtualLosses);
+
+			//Child value ranges from 0 to 1
+			float childValue;
+			if (node->gameState->getColor() == 'O') {
+				childValue = (1 + (childTotalValue / childVisits)) / 2;
 			} else {
-				//Substitutes 0.5 for childValue
-				selectionScore = 0.5f + EXPLORATION_PARAMETER * leafStateInfoIter->second.validMoveProbabilities.at(i) * sqrtf(leafStateInfoIter->second.visits + 1);
+				childValue = (1 - (childTotalValue / childVisits)) / 2;
 			}
+			
+			//Uses PUCT
+			selectionScore = childValue + EXPLORATION_PARAMETER * node->priors[i] * sqrtf(parentVisits + 1) / (childVisits + 1);
+		} else {
+			//Substitutes 0.5 for childValue
+			selectionScore = 0.5f + EXPLORATION_PARAMETER * node->priors[i] * sqrtf(parentVisits + 1);
+		}
 
-			if (selectionScore > bestSelectionScore) {
-				bestSelectionScore = selectionScore;
-				bestSelection = i;
+		if (selectionScore > bestSelectionScore) {
+			bestSelectionScore = selectionScore;
+			bestSelection = i;
+		}
+	}
+
+	return bestSelection;
+}
+
+template <unsigned int SIDE_LENGTH>
+typename SearchTree<SIDE_LENGTH>::Node* AdvancedMCTS<SIDE_LENGTH>::selectLeaf(typename SearchTree<SIDE_LENGTH>::Node* root, std::vector<PathStep>& path) {
+	path.clear();
+	typename SearchTree<SIDE_LENGTH>::Node* node = root;
+	float parentVisits = static_cast<float>(tree.rootVisits.load());
+	while (parentVisits > 0 && node->isExpanded() && node->gameState->getEndState() < -1) {
+		const unsigned int bestSelection = selectChild(node, parentVisits);
+		node->virtualLosses[bestSelection] += VIRTUAL_LOSS;
+		path.push_back({node, bestSelection});
+
+		parentVisits = static_cast<float>(node->visits[bestSelection].load());
+		node = tree.getChild(node, bestSelection);
+	}
+
+	return node;
+}
+
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::backup(typename SearchTree<SIDE_LENGTH>::Node* root, const std::vector<PathStep>& path, const float value) {
+	tree.backup(path, value);
+	if (transpositions == nullptr) {
+		return;
+	}
+
+	transpositions->update(TranspositionTable<SIDE_LENGTH>::getKey(root->gameState), value);
+	for (const PathStep& step : path) {
+		transpositions->update(TranspositionTable<SIDE_LENGTH>::getKey(step.node->children[step.index].load()->gameState), value);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+bool AdvancedMCTS<SIDE_LENGTH>::needsEvaluation(const typename SearchTree<SIDE_LENGTH>::Node* leaf, const std::vector<PathStep>& path) const {
+	return tree.getVisits(path) == 0 || (!leaf->isExpanded() && leaf->gameState->getEndState() < -1);
+}
+
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::simulateBatch(typename SearchTree<SIDE_LENGTH>::Node* root, const unsigned int count) {
+	std::vector<std::vector<PathStep>> paths(count);
+	std::vector<typename SearchTree<SIDE_LENGTH>::Node*> leaves;
+	std::vector<const GameState<SIDE_LENGTH>*> leafGameStates;
+	std::vector<unsigned int> leafPaths;
+	std::vector<std::chrono::steady_clock::duration> selectionTimes;
+	for (unsigned int i = 0; i < count; i++) {
+		const std::chrono::steady_clock::time_point selectionStart = std::chrono::steady_clock::now();
+		typename SearchTree<SIDE_LENGTH>::Node* leaf = selectLeaf(root, paths[i]);
+		const std::chrono::steady_clock::time_point evaluationStart = std::chrono::steady_clock::now();
+		if (!needsEvaluation(leaf, paths[i])) {
+			//Games that already ended do not need the neural network
+			backup(root, paths[i], leaf->gameState->getEndState());
+			this->recordSimulation(static_cast<unsigned int>(paths[i].size()), evaluationStart - selectionStart, std::chrono::steady_clock::now() - evaluationStart);
+			continue;
+		}
+
+		//Positions reached through other move orders do not need the neural network either
+		if (transpositions != nullptr) {
+			unsigned int symmetry;
+			const uint64_t key = TranspositionTable<SIDE_LENGTH>::getKey(leaf->gameState, symmetry);
+			std::vector<float> probabilities;
+			float value;
+			const bool transposed = evaluateTransposition(key, symmetry, probabilities, value);
+			this->recordTransposition(transposed);
+			if (transposed) {
+				tree.expand(leaf, probabilities);
+				backup(root, paths[i], value);
+				this->recordSimulation(static_cast<unsigned int>(paths[i].size()), evaluationStart - selectionStart, std::chrono::steady_clock::now() - evaluationStart);
+				continue;
 			}
 		}
 
-		GameState *child = potentialLeaf->getChild(bestSelection);
-		value = simulate(child);
+		leaves.emplace_back(leaf);
+		leafGameStates.emplace_back(leaf->gameState);
+		leafPaths.emplace_back(i);
+		selectionTimes.emplace_back(evaluationStart - selectionStart);
 	}
 
-	//Updates values
-	leafStateInfoIter->second.visits++;
-	leafStateInfoIter->second.totalValue += value;
+	if (leaves.empty()) {
+		return;
+	}
 
-	return value;
+	//Evaluates leaves, splitting the time of the batch evenly between them
+	const std::chrono::steady_clock::time_point evaluationStart = std::chrono::steady_clock::now();
+	const std::vector<std::pair<std::vector<float>, float>> results = neuralNetwork->predict(leafGameStates);
+	const std::chrono::steady_clock::duration evaluationTime = (std::chrono::steady_clock::now() - evaluationStart) / leaves.size();
+	for (unsigned int i = 0; i < leaves.size(); i++) {
+		if (transpositions != nullptr) {
+			unsigned int symmetry;
+			const uint64_t key = TranspositionTable<SIDE_LENGTH>::getKey(leaves[i]->gameState, symmetry);
+			transpositions->storeEvaluation(key, symmetry, results[i].first, results[i].second);
+		}
+		tree.expand(leaves[i], results[i].first);
+		backup(root, paths[leafPaths[i]], results[i].second);
+		this->recordSimulation(static_cast<unsigned int>(paths[leafPaths[i]].size()), selectionTimes[i], evaluationTime);
+	}
 }
 
-void AdvancedMCTS::runSimulations(GameState* gameState) {
-	for (unsigned int i = 0; i < simulations; i++) {
-		simulate(gameState);
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::runSimulations(GameState<SIDE_LENGTH>* gameState) {
+	typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
+
+	//Simulations kept from the previous search count towards this one
+	const unsigned int reusedVisits = std::min(tree.reusedVisits, this->simulations);
+	tree.reusedVisits = 0;
+	if (transpositions != nullptr) {
+		transpositions->newSearch();
+	}
+	unsigned int count = this->simulations - reusedVisits;
+	const unsigned int searchSimulations = count;
+	this->simulationsSaved = 0;
+	this->beginStats(reusedVisits);
+	const EvaluationCache<SIDE_LENGTH>* cache = neuralNetwork->getCache();
+	const unsigned long long cacheHits = cache != nullptr ? cache->getHits() : 0;
+	const unsigned long long cacheMisses = cache != nullptr ? cache->getMisses() : 0;
+
+	//Stops once the most visited move cannot be overtaken by the simulations left
+	std::function<bool(unsigned int)> isDecided;
+	if (this->earlyStopping) {
+		isDecided = [&](const unsigned int simulationCount) {
+			return tree.isDecided(count - simulationCount);
+		};
+	}
+
+	if (batchSize <= 1) {
+		this->simulationsRun = this->runWorkers(count, this->rng, [&](Random&) {
+			simulate(root);
+			return 1u;
+		}, isDecided, &tree);
+	} else {
+		//The root is evaluated on its own so batches start below it
+		this->simulationsRun = 0;
+		if (tree.rootVisits == 0 && count > 0) {
+			simulate(root);
+			this->simulationsRun++;
+			count--;
+		}
+
+		//Each batch takes the next batchSize simulations, with the last batch taking what is left
+		std::atomic<unsigned int> nextBatch = 0;
+		const unsigned int batchCount = count / batchSize + (count % batchSize != 0);
+		this->simulationsRun += this->runWorkers(batchCount, this->rng, [&](Random&) {
+			const unsigned int batch = nextBatch++;
+			const unsigned int batchSimulations = std::min(batchSize, count - batch * batchSize);
+			simulateBatch(root, batchSimulations);
+			return batchSimulations;
+		}, isDecided, &tree);
+	}
+
+	if (this->earlyStopping && tree.isDecided(searchSimulations - this->simulationsRun)) {
+		this->simulationsSaved = searchSimulations - this->simulationsRun;
+	}
+
+	this->endStats(tree.getNodeCount());
+	if (cache != nullptr) {
+		//Only counts the lookups made since the search started, which other searches sharing the neural network can add to
+		this->stats.cacheHits = cache->getHits() - cacheHits;
+		this->stats.cacheLookups = this->stats.cacheHits + cache->getMisses() - cacheMisses;
 	}
 }
 
-void AdvancedMCTS::addDirichletNoise(GameState* gameState) {
-	auto stateInfoIter = stateInfos.find(gameState);
-	if (stateInfoIter == stateInfos.end()) {
+template <unsigned int SIDE_LENGTH>
+void AdvancedMCTS<SIDE_LENGTH>::addDirichletNoise(GameState<SIDE_LENGTH>* gameState) {
+	typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
+	if (tree.rootVisits == 0) {
 		//Evaluates leaf
 		const std::pair<std::vector<float>, float> result = neuralNetwork->predict(gameState);
-
-		StateInfo stateInfo;
-		stateInfo.visits = 1;
-		stateInfo.validMoveProbabilities = result.first;
-		stateInfo.totalValue = result.second;
-		stateInfoIter = stateInfos.emplace(gameState, stateInfo).first;
+		tree.expand(root, result.first);
+		tree.rootVisits = 1;
+		tree.rootTotalValue = result.second;
 	}
 
 	std::vector<float> dirichlet;
-	dirichlet.resize(gameState->getValidMoves()->size());
+	dirichlet.resize(root->childCount);
 	float sum = 0.0f;
 	for (float& probability : dirichlet) {
-		probability = static_cast<float>(gamma(rng));
+		probability = static_cast<float>(gamma(this->rng));
 		sum += probability;
 	}
 
-	for (int i = 0; i < dirichlet.size(); i++) {
-		const float prior = stateInfoIter->second.validMoveProbabilities.at(i);
-		stateInfoIter->second.validMoveProbabilities.at(i) = (1 - DIRICHLET_SCALAR) * prior + DIRICHLET_SCALAR * (dirichlet.at(i) / sum);
+	for (unsigned int i = 0; i < dirichlet.size(); i++) {
+		const float prior = root->priors[i];
+		root->priors[i] = (1 - DIRICHLET_SCALAR) * prior + DIRICHLET_SCALAR * (dirichlet.at(i) / sum);
 	}
-}
\ No newline at end of file
+}
+
+template class AdvancedMCTS<5>;
+template class AdvancedMCTS<7>;
+template class AdvancedMCTS<9>;
+template class AdvancedMCTS<13>;
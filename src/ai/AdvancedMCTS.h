@@ -1,103 +1,163 @@
 #ifndef ADVANCED_MCTS_H
 #define ADVANCED_MCTS_H
 
+#include <memory>
 #include <random>
-#include <unordered_map>
 
 #include "MCTSConstants.h"
 #include "NeuralNetwork.h"
 
 #include "MCTS.h"
+#include "SearchTree.h"
+#include "TranspositionTable.h"
 
-class AdvancedMCTS : public MCTS {
+template <unsigned int SIDE_LENGTH>
+class AdvancedMCTS : public MCTS<SIDE_LENGTH> {
 public:
 	/**
 	 * @brief Constructs a new AdvancedMCTS object with the given number of simulations with a minimum of 1
 	 * @param neuralNetwork neural network used to predict probabilities and value of game states
 	 * @param simulations number of simulations to run each time
 	 */
-	explicit AdvancedMCTS(NeuralNetwork* neuralNetwork, unsigned int simulations);
+	explicit AdvancedMCTS(NeuralNetwork<SIDE_LENGTH>* neuralNetwork, unsigned int simulations);
 	
 	/**
 	 * @brief Returns the average value of a game state
 	 * @param gameState game state to evaluate
 	 * @return the average value of a game state
 	 */
-	float getMoveValue(const GameState* gameState) override;
+	float getMoveValue(const GameState<SIDE_LENGTH>* gameState) override;
 
 	/**
 	 * @brief Runs simulations on given game state and returns move probabilities corresponding to the number of times each move was visited
 	 * @param gameState game state to start simulations on
 	 * @return list of probabilities for each move
 	 */
-	std::vector<float> getMoveProbabilities(GameState* gameState) override;
+	std::vector<float> getMoveProbabilities(GameState<SIDE_LENGTH>* gameState) override;
 
 	/**
 	 * @brief Runs simulations on given game state and returns the best move which is the move visited the most
 	 * @param gameState game state to start simulations on
 	 * @return index of best move
 	 */
-	unsigned int getBestMove(GameState* gameState) override;
+	unsigned int getBestMove(GameState<SIDE_LENGTH>* gameState) override;
+
+	//Keeps the overload with search limits visible
+	using MCTS<SIDE_LENGTH>::getBestMove;
+
+	/**
+	 * @brief Sets the number of entries in the transposition table shared by nodes that reach the same position through different move orders, with 0 turning it off
+	 * @param size number of entries
+	 */
+	void setTranspositionTableSize(unsigned int size) override;
+
+	/**
+	 * @brief Makes the child reached by the given move the root, keeping its subtree so the next search continues from it
+	 * @param moveNum index of the move played in the root's valid moves
+	 */
+	void advance(unsigned int moveNum) override;
 
 	/**
 	 * @brief Resets MCTS tree
 	 */
 	void reset() override;
+
+	/**
+	 * @brief Sets the number of leaves each search thread collects before evaluating them together with a minimum of 1
+	 * @param batchSize number of leaves evaluated by each call to the neural network
+	 */
+	void setBatchSize(unsigned int batchSize);
 private:
-	struct StateInfo {
-		/**
-		 * @brief Holds the probabilities of making each valid move given by a neural network normalized so that the probabilities add up to one
-		 */
-		std::vector<float> validMoveProbabilities;
-		/**
-		 * @brief The number of times the corresponding game state was visited by a parent
-		 */
-		float visits = 0.0f;
-		/**
-		 * @brief The total value from all of the simulations that went past the corresponding game state
-		 */
-		float totalValue = 0.0f;
-	};
-	
+	using PathStep = typename SearchTree<SIDE_LENGTH>::PathStep;
+
 	/**
-	 * @brief Recursively looks for unexplored game state using game state's selection score, plays it out, then updates values based on the simulation result
-	 * @param potentialLeaf game state to simulate
+	 * @brief Looks for unexplored game state using selection scores, evaluates it, then updates values along the path taken based on the simulation result
+	 * @param root root node
 	 * @return final value of simulation
 	 */
-	float simulate(GameState* potentialLeaf);
+	float simulate(typename SearchTree<SIDE_LENGTH>::Node* root);
+
+	/**
+	 * @brief Evaluates a leaf from the transposition table if it holds the position, so the neural network is not needed
+	 * @param key key of the leaf's position
+	 * @param symmetry symmetry given along with the key
+	 * @param probabilities set to the stored move probabilities in the leaf's orientation if found
+	 * @param value set to the average value of the position across transpositions if found
+	 * @return whether the position was found
+	 */
+	bool evaluateTransposition(uint64_t key, unsigned int symmetry, std::vector<float>& probabilities, float& value) const;
+
+	/**
+	 * @brief Returns the index of the child to explore using PUCT, counting virtual losses as visits lost by the current player
+	 * @param node expanded node to select a child of
+	 * @param parentVisits number of times the node was visited
+	 * @return index of the selected child
+	 */
+	unsigned int selectChild(const typename SearchTree<SIDE_LENGTH>::Node* node, float parentVisits) const;
+
+	/**
+	 * @brief Follows selection from the root until reaching a node that was never visited, was pruned since it was visited or ends the game, adding virtual losses along the way
+	 * @param root root node
+	 * @param path cleared then filled with the steps taken from the root
+	 * @return node reached
+	 */
+	typename SearchTree<SIDE_LENGTH>::Node* selectLeaf(typename SearchTree<SIDE_LENGTH>::Node* root, std::vector<PathStep>& path);
+
+	/**
+	 * @brief Adds a simulation result to every node on a path and to the positions they hold in the transposition table
+	 * @param root root node
+	 * @param path steps taken from the root
+	 * @param value final value of simulation
+	 */
+	void backup(typename SearchTree<SIDE_LENGTH>::Node* root, const std::vector<PathStep>& path, float value);
+
+	/**
+	 * @brief Returns whether a leaf needs the neural network, which is when it was never visited or when it was pruned and has to be expanded again
+	 * @param leaf leaf reached by selection
+	 * @param path steps taken from the root to the leaf
+	 * @return whether the leaf needs evaluating
+	 */
+	bool needsEvaluation(const typename SearchTree<SIDE_LENGTH>::Node* leaf, const std::vector<PathStep>& path) const;
+
+	/**
+	 * @brief Selects the given number of leaves, evaluates them with one call to the neural network, then updates values based on every result
+	 * @param root root node
+	 * @param count number of simulations to run
+	 */
+	void simulateBatch(typename SearchTree<SIDE_LENGTH>::Node* root, unsigned int count);
 
 	/**
 	 * @brief Runs simulations on given game state
 	 * @param gameState game state to start simulations on
 	 */
-	void runSimulations(GameState* gameState);
+	void runSimulations(GameState<SIDE_LENGTH>* gameState);
 
 	/**
-	 * @brief Adds dirichlet noise to game state's move probabilities
-	 * @param gameState game state to add noise to
+	 * @brief Adds dirichlet noise to the root's move probabilities, evaluating it first if needed
+	 * @param gameState game state at the root
 	 */
-	void addDirichletNoise(GameState* gameState);
+	void addDirichletNoise(GameState<SIDE_LENGTH>* gameState);
 
 	/**
 	 * @brief The neural network used to predict the value and move probabilities of game boards
 	 */
-	NeuralNetwork* neuralNetwork;
+	NeuralNetwork<SIDE_LENGTH>* neuralNetwork;
+	/**
+	 * @brief The number of leaves each search thread evaluates at once
+	 */
+	unsigned int batchSize = 1;
 	/**
-	 * @brief Maps game state keys to their state information
+	 * @brief Search statistics for the game states explored
 	 */
-	std::unordered_map<const GameState*, StateInfo> stateInfos;
+	SearchTree<SIDE_LENGTH> tree;
 	/**
-     * @brief Used to seed rng
-     */
-	inline static std::random_device seeder;
-	/** 
-	 * @brief Used to generate random unsigned 64 bit integers
+	 * @brief Statistics and neural network evaluations merged across transpositions, or null if turned off
 	 */
-	inline static std::mt19937_64 rng = std::mt19937_64(seeder());
+	std::unique_ptr<TranspositionTable<SIDE_LENGTH>> transpositions;
 	/**
-	 * @brief Used to generate elements in dirichlet distribution
+	 * @brief Used to generate elements in dirichlet distribution, which each search keeps for itself since it carries state between draws
 	 */
-	inline static std::gamma_distribution<> gamma = std::gamma_distribution<>(ALPHA, 1);
+	std::gamma_distribution<> gamma = std::gamma_distribution<>(ALPHA, 1);
 };
 
 #endif
\ No newline at end of file
@@ -1,51 +1,78 @@
+#include <algorithm>
+#include <atomic>
+
 #include "MCTSConstants.h"
 #include "../game/GameStateConstants.h"
+#include "../game/GameStatePool.h"
+#include "../game/RolloutBoard.h"
 
 #include "BasicMCTS.h"
 
-BasicMCTS::BasicMCTS(const unsigned int simulations) : MCTS(simulations) {
+template <unsigned int SIDE_LENGTH>
+BasicMCTS<SIDE_LENGTH>::BasicMCTS(const unsigned int simulations) : MCTS<SIDE_LENGTH>(simulations) {
 }
 
-float BasicMCTS::getMoveValue(const GameState* gameState) {
-	auto const gameStateIter = stateInfos.find(gameState);
-	if (gameStateIter != stateInfos.end()) {
-		return gameStateIter->second.totalValue / gameStateIter->second.playouts;
+template <unsigned int SIDE_LENGTH>
+float BasicMCTS<SIDE_LENGTH>::getMoveValue(const GameState<SIDE_LENGTH>* gameState) {
+	float visits;
+	float totalValue;
+	if (tree.getStatistics(gameState, visits, totalValue)) {
+		return totalValue / visits;
 	}
 	
 	return 0;
 }
 
-std::vector<float> BasicMCTS::getMoveProbabilities(GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+std::vector<float> BasicMCTS<SIDE_LENGTH>::getMoveProbabilities(GameState<SIDE_LENGTH>* gameState) {
 	runSimulations(gameState);
+	const typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
 
 	float totalSimulations = 1;
-	if (stateInfos.find(gameState) != stateInfos.end()) {
-		totalSimulations = stateInfos.at(gameState).playouts;
+	if (tree.rootVisits > 0) {
+		totalSimulations = tree.rootVisits;
 	}
 
 	std::vector<float> newMoveProbabilities;
-	newMoveProbabilities.resize(NUM_MOVES);
-	for (unsigned int i = 0; i < NUM_MOVES; i++) {
+	newMoveProbabilities.resize(NUM_MOVES<SIDE_LENGTH>);
+	for (unsigned int i = 0; i < NUM_MOVES<SIDE_LENGTH>; i++) {
 		newMoveProbabilities[i] = 0;
 	}
 
-	for (unsigned int i = 0; i < gameState->getValidMoves()->size(); i++) {
-		auto const childStateIter = stateInfos.find(gameState->getChild(i));
-		if (childStateIter != stateInfos.end()) {
-			newMoveProbabilities[gameState->getValidMoves()->at(i) + 1] = childStateIter->second.playouts / totalSimulations;
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		if (root->visits[i] > 0) {
+			newMoveProbabilities[gameState->getValidMoves()->at(i) + 1] = root->visits[i] / totalSimulations;
 		}
 	}
 
 	return newMoveProbabilities;
 }
 
-unsigned int BasicMCTS::getBestMove(GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+unsigned int BasicMCTS<SIDE_LENGTH>::getBestMove(GameState<SIDE_LENGTH>* gameState) {
 	runSimulations(gameState);
+	const typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
+
+	//RAVE sends most visits to the best moves early, leaving the averages of the rest based on a few noisy simulations
+	if (raveEquivalence > 0) {
+		unsigned int bestMove = 0;
+		unsigned int mostVisits = 0;
+		for (unsigned int i = 0; i < root->childCount; i++) {
+			if (root->visits[i] > mostVisits) {
+				mostVisits = root->visits[i];
+				bestMove = i;
+			}
+		}
+		return bestMove;
+	}
 	
 	unsigned int bestMove = 0;
 	float bestMoveValue = -1;
 	for (unsigned int i = 0; i < gameState->getValidMoves()->size(); i++) {
-		float moveValue = getMoveValue(gameState->getChild(i));
+		float moveValue = 0;
+		if (i < root->childCount && root->visits[i] > 0) {
+			moveValue = root->totalValues[i] / root->visits[i];
+		}
 		if (gameState->getColor() == 'X') {
 			moveValue = 1 - moveValue;
 		}
@@ -59,76 +86,310 @@ unsigned int BasicMCTS::getBestMove(GameState* gameState) {
 	return bestMove;
 }
 
-void BasicMCTS::reset() {
-	stateInfos.clear();
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::setTranspositionTableSize(const unsigned int size) {
+	if (size == 0) {
+		transpositions = nullptr;
+	} else {
+		transpositions = std::make_unique<TranspositionTable<SIDE_LENGTH>>(size, false);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::setParallelMode(const ParallelMode parallelMode) {
+	this->parallelMode = parallelMode;
+	updatePlayoutPool();
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::setThreads(const unsigned int threads) {
+	MCTS<SIDE_LENGTH>::setThreads(threads);
+	updatePlayoutPool();
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::setRaveEquivalence(const unsigned int equivalence) {
+	raveEquivalence = equivalence;
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::advance(const unsigned int moveNum) {
+	tree.advance(moveNum);
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::reset() {
+	tree.clear();
+	if (transpositions != nullptr) {
+		transpositions->clear();
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::updatePlayoutPool() {
+	if (parallelMode != ParallelMode::LEAF || this->threads <= 1) {
+		playoutPool = nullptr;
+	} else if (playoutPool == nullptr || playoutPool->getThreads() != this->threads) {
+		playoutPool = std::make_unique<PlayoutPool<SIDE_LENGTH>>(this->threads, this->rng, &BasicMCTS::playout);
+	}
 }
 
-float BasicMCTS::simulate(GameState* potentialLeaf) {
+template <unsigned int SIDE_LENGTH>
+float BasicMCTS<SIDE_LENGTH>::simulate(SearchTree<SIDE_LENGTH>& searchTree, typename SearchTree<SIDE_LENGTH>::Node* root, Random& threadRng) {
+	//Reuses one path buffer per thread so simulations do not allocate
+	thread_local std::vector<PathStep> path;
+	const std::chrono::steady_clock::time_point selectionStart = std::chrono::steady_clock::now();
+	typename SearchTree<SIDE_LENGTH>::Node* leaf = selectLeaf(searchTree, root, path);
+	const std::chrono::steady_clock::time_point evaluationStart = std::chrono::steady_clock::now();
+
 	float value;
-	
-	auto leafStateInfoIter = stateInfos.find(potentialLeaf);
-	const float endState = potentialLeaf->getEndState();
-	if (leafStateInfoIter == stateInfos.end()) {
+	float leafValue;
+	Bitboard<SIDE_LENGTH> blackCells;
+	Bitboard<SIDE_LENGTH> whiteCells;
+	if (searchTree.getVisits(path) == 0) {
 		//Evaluates leaf
-		value = playout(potentialLeaf);
-		
-		StateInfo stateInfo;
-		leafStateInfoIter = stateInfos.emplace(potentialLeaf, stateInfo).first;
-	} else if (endState >= -1) {
-		value = endState;
+		if (playoutPool != nullptr) {
+			value = playoutPool->playout(leaf->gameState, threadRng);
+		} else if (raveEquivalence > 0) {
+			value = recordPlayout(leaf->gameState, threadRng, blackCells, whiteCells);
+		} else {
+			value = playout(leaf->gameState, threadRng);
+		}
+
+		leafValue = value;
+
+		//Merges the playout into what other move orders found for the same position, while only the playout is added to its entry so the stored statistics count once
+		float transpositionVisits;
+		float transpositionTotalValue;
+		bool transposed = false;
+		if (transpositions != nullptr) {
+			transposed = transpositions->getStatistics(TranspositionTable<SIDE_LENGTH>::getKey(leaf->gameState), transpositionVisits, transpositionTotalValue);
+			this->recordTransposition(transposed);
+		}
+		if (transposed) {
+			value = (transpositionTotalValue + value) / (transpositionVisits + 1);
+		}
 	} else {
-		//Selects child to explore
-		float bestSelectionScore = -1;
-		unsigned int bestSelection = 0;
-		for (unsigned int i = 0; i < potentialLeaf->getValidMoves()->size(); i++) {
-			auto childStateInfoIter = stateInfos.find(potentialLeaf->getChild(i));
-			if (childStateInfoIter == stateInfos.end()) {
-				bestSelection = i;
-				break;
-			}
-			
-			const StateInfo* childStateInfo = &childStateInfoIter->second;
-			//Uses UCT for score
-			float selectionScore = EXPLORATION_PARAMETER * sqrtf(log(leafStateInfoIter->second.playouts) / (childStateInfo->playouts + 1));
-			if (potentialLeaf->getColor() == 'O') {
-				selectionScore += (1 + (childStateInfo->totalValue / childStateInfo->playouts)) / 2;
-			} else {
-				selectionScore += (1 - (childStateInfo->totalValue / childStateInfo->playouts)) / 2;
-			}
+		value = leaf->gameState->getEndState();
+		leafValue = value;
+	}
+	const std::chrono::steady_clock::time_point evaluationEnd = std::chrono::steady_clock::now();
 
-			if (selectionScore > bestSelectionScore) {
-				bestSelectionScore = selectionScore;
-				bestSelection = i;
-			}
+	if (raveEquivalence > 0) {
+		searchTree.backupAmaf(path, leafValue, blackCells, whiteCells);
+	}
+	backup(searchTree, root, path, value, leafValue);
+	this->recordSimulation(static_cast<unsigned int>(path.size()), evaluationStart - selectionStart, evaluationEnd - evaluationStart);
+
+	return value;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int BasicMCTS<SIDE_LENGTH>::selectChild(const typename SearchTree<SIDE_LENGTH>::Node* node, const float parentVisits) const {
+	//Virtual losses count as visits the current player lost
+	const float lossValue = node->gameState->getColor() == 'O' ? -1.0f : 1.0f;
+	const float explorationParameter = raveEquivalence > 0 ? RAVE_EXPLORATION_PARAMETER : EXPLORATION_PARAMETER;
+
+	float bestSelectionScore = -1;
+	unsigned int bestSelection = 0;
+	for (unsigned int i = 0; i < node->childCount; i++) {
+		const unsigned int virtualLosses = node->virtualLosses[i];
+		const unsigned int childVisits = node->visits[i] + virtualLosses;
+		const unsigned int amafVisits = raveEquivalence > 0 ? node->amafVisits[i].load() : 0;
+		if (childVisits == 0 && amafVisits == 0) {
+			return i;
+		}
+
+		float childValue = 0;
+		if (childVisits > 0) {
+			childValue = (node->totalValues[i] + lossValue * static_cast<float>(virtualLosses)) / childVisits;
+		}
+		if (amafVisits > 0) {
+			//Leans on the all moves as first value while the move has few visits of its own
+			const auto equivalence = static_cast<float>(raveEquivalence);
+			const float amafWeight = sqrtf(equivalence / (3 * static_cast<float>(childVisits) + equivalence));
+			childValue = (1 - amafWeight) * childValue + amafWeight * node->amafTotalValues[i] / static_cast<float>(amafVisits);
+		}
+
+		//Uses UCT for score
+		float selectionScore = explorationParameter * sqrtf(log(parentVisits) / (childVisits + 1));
+		if (node->gameState->getColor() == 'O') {
+			selectionScore += (1 + childValue) / 2;
+		} else {
+			selectionScore += (1 - childValue) / 2;
+		}
+
+		if (selectionScore > bestSelectionScore) {
+			bestSelectionScore = selectionScore;
+			bestSelection = i;
 		}
+	}
+
+	return bestSelection;
+}
+
+template <unsigned int SIDE_LENGTH>
+typename SearchTree<SIDE_LENGTH>::Node* BasicMCTS<SIDE_LENGTH>::selectLeaf(SearchTree<SIDE_LENGTH>& searchTree, typename SearchTree<SIDE_LENGTH>::Node* root, std::vector<PathStep>& path) {
+	path.clear();
+	typename SearchTree<SIDE_LENGTH>::Node* node = root;
+	float parentVisits = static_cast<float>(searchTree.rootVisits.load());
+	while (parentVisits > 0 && node->gameState->getEndState() < -1) {
+		if (!node->isExpanded()) {
+			searchTree.expand(node);
+		}
+
+		const unsigned int bestSelection = selectChild(node, parentVisits);
+		node->virtualLosses[bestSelection] += VIRTUAL_LOSS;
+		path.push_back({node, bestSelection});
 
-		GameState *child = potentialLeaf->getChild(bestSelection);
-		value = simulate(child);
+		parentVisits = static_cast<float>(node->visits[bestSelection].load());
+		node = searchTree.getChild(node, bestSelection);
 	}
 
-	//Updates values
-	leafStateInfoIter->second.playouts++;
-	leafStateInfoIter->second.totalValue += value;
+	return node;
+}
 
-	return value;
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::backup(SearchTree<SIDE_LENGTH>& searchTree, typename SearchTree<SIDE_LENGTH>::Node* root, const std::vector<PathStep>& path, const float value, const float leafValue) {
+	searchTree.backup(path, value);
+	if (transpositions == nullptr) {
+		return;
+	}
+
+	//The leaf is the root when the path is empty, otherwise the child taken by the last step
+	transpositions->update(TranspositionTable<SIDE_LENGTH>::getKey(root->gameState), path.empty() ? leafValue : value);
+	for (size_t i = 0; i < path.size(); i++) {
+		const PathStep& step = path[i];
+		transpositions->update(TranspositionTable<SIDE_LENGTH>::getKey(step.node->children[step.index].load()->gameState), i + 1 == path.size() ? leafValue : value);
+	}
 }
 
-float BasicMCTS::playout(GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+float BasicMCTS<SIDE_LENGTH>::playout(const GameState<SIDE_LENGTH>* gameState, Random& threadRng) {
 	const float endState = gameState->getEndState();
 	if (endState >= -1) {
 		return endState;
 	}
 
-	std::uniform_int_distribution<int> distribution(0, static_cast<int>(gameState->getValidMoves()->size() - 1));
-	GameState* child = gameState->getChild(distribution(rng), false);
-	const float value = playout(child);
-	
-	delete child;
-	return value;
+	RolloutBoard<SIDE_LENGTH> board(gameState);
+	while (!board.isOver()) {
+		board.play(board.getRandomMove(threadRng));
+	}
+
+	return board.getScore();
 }
 
-void BasicMCTS::runSimulations(GameState* gameState) {
-	for (unsigned int i = 0; i < simulations; i++) {
-		simulate(gameState);
+template <unsigned int SIDE_LENGTH>
+float BasicMCTS<SIDE_LENGTH>::recordPlayout(const GameState<SIDE_LENGTH>* gameState, Random& threadRng, Bitboard<SIDE_LENGTH>& blackCells, Bitboard<SIDE_LENGTH>& whiteCells) {
+	const float endState = gameState->getEndState();
+	if (endState >= -1) {
+		return endState;
+	}
+
+	//Passes switch players too, so the mover is tracked alongside the board
+	RolloutBoard<SIDE_LENGTH> board(gameState);
+	char color = gameState->getColor();
+	while (!board.isOver()) {
+		const int move = board.getRandomMove(threadRng);
+		if (move >= 0) {
+			(color == 'O' ? whiteCells : blackCells).set(move);
+		}
+		board.play(move);
+		color = GameState<SIDE_LENGTH>::flipColor(color);
 	}
-}
\ No newline at end of file
+
+	return board.getScore();
+}
+
+template <unsigned int SIDE_LENGTH>
+void BasicMCTS<SIDE_LENGTH>::runSimulations(GameState<SIDE_LENGTH>* gameState) {
+	typename SearchTree<SIDE_LENGTH>::Node* root = tree.getRoot(gameState);
+
+	//Simulations kept from the previous search count towards this one
+	const unsigned int reusedVisits = std::min(tree.reusedVisits, this->simulations);
+	tree.reusedVisits = 0;
+	if (transpositions != nullptr) {
+		transpositions->newSearch();
+	}
+	const unsigned int count = this->simulations - reusedVisits;
+	this->simulationsSaved = 0;
+	this->beginStats(reusedVisits);
+
+	//RAVE picks the most visited move, so it stops like AdvancedMCTS once no other move can catch up, while plain UCT picks by average value, so it stops once no other average could pass the best
+	std::function<bool(unsigned int)> isDecided;
+	if (this->earlyStopping) {
+		isDecided = [&](const unsigned int simulationCount) {
+			return raveEquivalence > 0 ? tree.isDecided(count - simulationCount) : tree.isValueDecided(count - simulationCount);
+		};
+	}
+
+	size_t otherTreeNodes = 0;
+	if (this->threads > 1 && parallelMode == ParallelMode::ROOT) {
+		otherTreeNodes = runRootParallel(gameState, count);
+	} else if (this->threads > 1 && parallelMode == ParallelMode::LEAF) {
+		//Only the calling thread touches the tree, so the game states being played out never change underneath the pool
+		playoutPool->reseed(this->rng);
+		this->simulationsRun = 0;
+		while (this->simulationsRun < count && this->hasTime() && !(isDecided && isDecided(this->simulationsRun))) {
+			this->makeRoom(tree);
+			simulate(tree, root, this->rng);
+			this->simulationsRun++;
+		}
+	} else {
+		this->simulationsRun = this->runWorkers(count, this->rng, [&](Random& threadRng) {
+			simulate(tree, root, threadRng);
+			return 1u;
+		}, isDecided, &tree);
+	}
+
+	if (isDecided && isDecided(this->simulationsRun)) {
+		this->simulationsSaved = count - this->simulationsRun;
+	}
+
+	this->endStats(tree.getNodeCount() + otherTreeNodes);
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t BasicMCTS<SIDE_LENGTH>::runRootParallel(GameState<SIDE_LENGTH>* gameState, const unsigned int count) {
+	const unsigned int treeCount = this->threads;
+
+	//The first tree is the main tree, and the rest search copies of the game state in their own pools since game states are not thread safe
+	std::vector<std::unique_ptr<GameStatePool<SIDE_LENGTH>>> pools;
+	std::vector<std::unique_ptr<SearchTree<SIDE_LENGTH>>> trees;
+	std::vector<typename SearchTree<SIDE_LENGTH>::Node*> roots = {tree.getRoot(gameState)};
+	for (unsigned int i = 1; i < treeCount; i++) {
+		pools.push_back(std::make_unique<GameStatePool<SIDE_LENGTH>>());
+		trees.push_back(std::make_unique<SearchTree<SIDE_LENGTH>>());
+		roots.push_back(trees.back()->getRoot(gameState->copy(pools.back().get())));
+	}
+
+	std::atomic<unsigned int> nextTree = 0;
+	this->simulationsRun = this->runWorkers(treeCount, this->rng, [&](Random& threadRng) {
+		const unsigned int index = nextTree++;
+		SearchTree<SIDE_LENGTH>& searchTree = index == 0 ? tree : *trees[index - 1];
+		const unsigned int share = count / treeCount + (index < count % treeCount ? 1 : 0);
+
+		unsigned int simulationCount = 0;
+		//Each tree only knows its own share of the statistics, so only a forced move ends its search early
+		while (simulationCount < share && this->hasTime() && !(this->earlyStopping && searchTree.isForced())) {
+			//Only this thread searches this tree, so it can be pruned between simulations, with the trees splitting the node limit so the whole search stays within it
+			this->makeRoom(searchTree, treeCount);
+			simulate(searchTree, roots[index], threadRng);
+			simulationCount++;
+		}
+		return simulationCount;
+	});
+
+	size_t otherTreeNodes = 0;
+	for (const std::unique_ptr<SearchTree<SIDE_LENGTH>>& other : trees) {
+		tree.merge(*other);
+		otherTreeNodes += other->getNodeCount();
+	}
+
+	return otherTreeNodes;
+}
+
+template class BasicMCTS<5>;
+template class BasicMCTS<7>;
+template class BasicMCTS<9>;
+template class BasicMCTS<13>;
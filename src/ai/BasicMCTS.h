@@ -1,12 +1,33 @@
 #ifndef BASIC_MCTS_H
 #define BASIC_MCTS_H
 
-#include <random>
-#include <unordered_map>
+#include <memory>
 
 #include "MCTS.h"
+#include "PlayoutPool.h"
+#include "SearchTree.h"
+#include "TranspositionTable.h"
 
-class BasicMCTS : public MCTS {
+/**
+ * @brief How BasicMCTS splits a search between threads
+ */
+enum class ParallelMode {
+	/**
+	 * @brief Every thread searches one shared tree, steered apart by virtual losses
+	 */
+	TREE,
+	/**
+	 * @brief Every thread searches its own tree, with the trees' root statistics merged once they are done
+	 */
+	ROOT,
+	/**
+	 * @brief The calling thread searches the tree alone while every thread plays out each new leaf
+	 */
+	LEAF
+};
+
+template <unsigned int SIDE_LENGTH>
+class BasicMCTS : public MCTS<SIDE_LENGTH> {
 public:
 	/**
 	 * @brief Constructs a new BasicMCTS object with the given number of simulations with a minimum of 1
@@ -19,70 +40,157 @@ public:
 	 * @param gameState game state to evaluate
 	 * @return the average value of a game state
 	 */
-	float getMoveValue(const GameState* gameState) override;
+	float getMoveValue(const GameState<SIDE_LENGTH>* gameState) override;
 
 	/**
 	 * @brief Runs simulations on given game state and returns move probabilities corresponding to the number of times each move was visited
 	 * @param gameState game state to start simulations on
 	 * @return list of probabilities for each move
 	 */
-	std::vector<float> getMoveProbabilities(GameState* gameState);
+	std::vector<float> getMoveProbabilities(GameState<SIDE_LENGTH>* gameState);
 
 	/**
-	 * @brief Runs simulations on given game state and returns the best move which is the move with the highest average value
+	 * @brief Runs simulations on given game state and returns the best move which is the move with the highest average value, or the most visited move if RAVE is on
 	 * @param gameState game state to start simulations on
 	 * @return index of best move
 	 */
-	unsigned int getBestMove(GameState* gameState) override;
+	unsigned int getBestMove(GameState<SIDE_LENGTH>* gameState) override;
+
+	//Keeps the overload with search limits visible
+	using MCTS<SIDE_LENGTH>::getBestMove;
+
+	/**
+	 * @brief Sets the number of entries in the transposition table shared by nodes that reach the same position through different move orders, with 0 turning it off
+	 * @param size number of entries
+	 */
+	void setTranspositionTableSize(unsigned int size) override;
+
+	/**
+	 * @brief Sets how the search is split between threads, which only matters with more than 1 thread
+	 * @param parallelMode how to split the search
+	 */
+	void setParallelMode(ParallelMode parallelMode);
+
+	/**
+	 * @brief Sets the number of threads searching at once with a minimum of 1, starting or stopping the playout threads of leaf parallel searches to match
+	 * @param threads number of threads to search with
+	 */
+	void setThreads(unsigned int threads) override;
+
+	/**
+	 * @brief Sets how long selection leans on rapid action value estimation (RAVE), which blends each move's value with the value of every simulation that played the move later on for the same player, with 0 turning it off
+	 *
+	 * The all moves as first value gets weight sqrt(equivalence / (3 * visits + equivalence)), so it decides unvisited moves on its own and counts as much as the move's own value once the move has been visited equivalence times. Leaf parallel searches only count the moves made in the tree.
+	 * @param equivalence number of visits where a move's own value and its all moves as first value are weighted equally, with RAVE_EQUIVALENCE working well on small boards
+	 */
+	void setRaveEquivalence(unsigned int equivalence);
+
+	/**
+	 * @brief Makes the child reached by the given move the root, keeping its subtree so the next search continues from it
+	 * @param moveNum index of the move played in the root's valid moves
+	 */
+	void advance(unsigned int moveNum) override;
 
 	/**
 	 * @brief Resets MCTS tree
 	 */
 	void reset() override;
 private:
-	struct StateInfo {
-		/**
-		 * @brief The number of playouts run by the corresponding game state
-		 */
-		float playouts = 0;
-		/**
-		 * @brief The total value from all of the simulations that went past the corresponding game state
-		 */
-		float totalValue = 0;
-	};
-	
+	using PathStep = typename SearchTree<SIDE_LENGTH>::PathStep;
+
 	/**
-	 * @brief Recursively looks for unexplored game state using game state's selection score, plays it out, then updates values based on the simulation result
-	 * @param potentialLeaf game state to simulate
+	 * @brief Looks for unexplored game state using selection scores, plays it out, then updates values along the path taken based on the simulation result
+	 * @param searchTree tree to search
+	 * @param root root node of the tree
+	 * @param threadRng random number generator of the thread running the simulation
 	 * @return final value of simulation
 	 */
-	float simulate(GameState* potentialLeaf);
+	float simulate(SearchTree<SIDE_LENGTH>& searchTree, typename SearchTree<SIDE_LENGTH>::Node* root, Random& threadRng);
+
+	/**
+	 * @brief Returns the index of the child to explore using UCT, counting virtual losses as visits lost by the current player and blending in all moves as first values if RAVE is on
+	 * @param node expanded node to select a child of
+	 * @param parentVisits number of times the node was visited
+	 * @return index of the selected child
+	 */
+	unsigned int selectChild(const typename SearchTree<SIDE_LENGTH>::Node* node, float parentVisits) const;
+
+	/**
+	 * @brief Follows selection from the root until reaching a node that was never visited or that ends the game, expanding nodes and adding virtual losses along the way
+	 * @param searchTree tree to search
+	 * @param root root node of the tree
+	 * @param path cleared then filled with the steps taken from the root
+	 * @return node reached
+	 */
+	typename SearchTree<SIDE_LENGTH>::Node* selectLeaf(SearchTree<SIDE_LENGTH>& searchTree, typename SearchTree<SIDE_LENGTH>::Node* root, std::vector<PathStep>& path);
+
+	/**
+	 * @brief Adds a simulation result to every node on a path and to the positions they hold in the transposition table
+	 * @param searchTree tree the path was taken in
+	 * @param root root node of the tree
+	 * @param path steps taken from the root
+	 * @param value final value of simulation
+	 * @param leafValue value added to the position of the leaf in the transposition table, which leaves out the statistics already stored there
+	 */
+	void backup(SearchTree<SIDE_LENGTH>& searchTree, typename SearchTree<SIDE_LENGTH>::Node* root, const std::vector<PathStep>& path, float value, float leafValue);
 	
 	/**
-	 * @brief Plays out given game state to its end
+	 * @brief Plays out given game state to its end with random moves on a rollout board, leaving the tree untouched
+	 * @param gameState game state to play out
+	 * @param threadRng random number generator of the thread running the playout
+	 * @return end state value
+	 */
+	static float playout(const GameState<SIDE_LENGTH>* gameState, Random& threadRng);
+
+	/**
+	 * @brief Plays out given game state like playout while recording the cells each player placed a piece on
 	 * @param gameState game state to play out
+	 * @param threadRng random number generator of the thread running the playout
+	 * @param blackCells cells black placed a piece on are added to this
+	 * @param whiteCells cells white placed a piece on are added to this
 	 * @return end state value
 	 */
-	static float playout(GameState* gameState);
+	static float recordPlayout(const GameState<SIDE_LENGTH>* gameState, Random& threadRng, Bitboard<SIDE_LENGTH>& blackCells, Bitboard<SIDE_LENGTH>& whiteCells);
 
 	/**
 	 * @brief Runs simulations on given game state
 	 * @param gameState game state to start simulations on
 	 */
-	void runSimulations(GameState* gameState);
+	void runSimulations(GameState<SIDE_LENGTH>* gameState);
+
+	/**
+	 * @brief Runs simulations on a separate tree for each thread, each searching its own copy of the game state, then merges the trees' root statistics into the main tree
+	 * @param gameState game state to start simulations on
+	 * @param count number of simulations to run across every tree
+	 * @return number of nodes the other trees held before being freed
+	 */
+	size_t runRootParallel(GameState<SIDE_LENGTH>* gameState, unsigned int count);
+
+	/**
+	 * @brief Starts the playout threads when searching leaf parallel on more than 1 thread and stops them otherwise, keeping a pool that already has the right number of threads
+	 */
+	void updatePlayoutPool();
 	
 	/**
-	 * @brief Maps game state keys to their state information
+	 * @brief Search statistics for the game states explored
+	 */
+	SearchTree<SIDE_LENGTH> tree;
+	/**
+	 * @brief Statistics merged across transpositions, or null if turned off
+	 */
+	std::unique_ptr<TranspositionTable<SIDE_LENGTH>> transpositions;
+	/**
+	 * @brief How the search is split between threads
+	 */
+	ParallelMode parallelMode = ParallelMode::TREE;
+	/**
+	 * @brief Number of visits where a move's own value and its all moves as first value are weighted equally, or 0 if RAVE is off
 	 */
-	std::unordered_map<const GameState*, StateInfo> stateInfos;
+	unsigned int raveEquivalence = 0;
 	/**
-     * @brief Used to seed rng
-     */
-	inline static std::random_device seeder;
-	/** 
-	 * @brief Used to generate random unsigned 64 bit integers
+	 * @brief Threads playing out each new leaf during leaf parallel searches, kept between searches, or null when not searching leaf parallel
 	 */
-	inline static std::mt19937_64 rng = std::mt19937_64(seeder());
+	std::unique_ptr<PlayoutPool<SIDE_LENGTH>> playoutPool;
 };
 
 #endif
\ No newline at end of file
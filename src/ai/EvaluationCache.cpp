@@ -0,0 +1,132 @@
+#include <algorithm>
+
+#include "../game/GameStateConstants.h"
+#include "../game/Symmetry.h"
+#include "../game/Zobrist.h"
+
+#include "GameStateData.h"
+
+#include "EvaluationCache.h"
+
+/**
+ * @brief Key XORed into the keys of game states where white is to move
+ */
+constexpr uint64_t WHITE_TO_MOVE_KEY = 0x6B1F93C2D45E08A7;
+
+template <unsigned int SIDE_LENGTH>
+EvaluationCache<SIDE_LENGTH>::EvaluationCache(const unsigned int capacity) : shardCapacity(std::max(1u, (capacity + SHARD_COUNT - 1) / SHARD_COUNT)) {
+	for (Shard& shard : shards) {
+		shard.indices.reserve(shardCapacity);
+		shard.entries.reserve(shardCapacity);
+		shard.priors.reserve(static_cast<size_t>(shardCapacity) * NUM_MOVES<SIDE_LENGTH>);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+uint64_t EvaluationCache<SIDE_LENGTH>::getKey(const GameState<SIDE_LENGTH>* gameState, unsigned int& symmetry) {
+	return getCanonicalKey([gameState](const unsigned int candidate) {
+		uint64_t key = hashPosition(*gameState->getPosition(), candidate);
+		if (gameState->getColor() == 'O') {
+			key ^= WHITE_TO_MOVE_KEY;
+		}
+
+		//Mixes the key before adding each previous board, since boards one move apart share most of their hash and would cancel out, and so boards in a different order or a shorter history give a different key
+		constexpr unsigned int MAX_PREVIOUS_POSITIONS = GAME_STATE_DATA_PLANES / 2 - 2;
+		unsigned int previousCount = 0;
+		for (const PositionHistory<SIDE_LENGTH>* entry = gameState->getHistory(); entry != nullptr && previousCount < MAX_PREVIOUS_POSITIONS; entry = entry->getPrevious()) {
+			uint64_t state = key;
+			key = splitMix64(state) ^ hashPosition(entry->getPosition(), candidate);
+			previousCount++;
+		}
+
+		uint64_t state = key;
+		return splitMix64(state);
+	}, symmetry);
+}
+
+template <unsigned int SIDE_LENGTH>
+bool EvaluationCache<SIDE_LENGTH>::get(const uint64_t key, const unsigned int symmetry, std::vector<float>& probabilities, float& value) {
+	Shard& shard = getShard(key);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	const auto found = shard.indices.find(key);
+	if (found == shard.indices.end()) {
+		misses++;
+		return false;
+	}
+
+	Entry& entry = shard.entries[found->second];
+	entry.referenced = true;
+	probabilities.resize(NUM_MOVES<SIDE_LENGTH>);
+	undoSymmetry<SIDE_LENGTH>(shard.priors.data() + static_cast<size_t>(found->second) * NUM_MOVES<SIDE_LENGTH>, symmetry, probabilities.data());
+	value = entry.value;
+	hits++;
+	return true;
+}
+
+template <unsigned int SIDE_LENGTH>
+void EvaluationCache<SIDE_LENGTH>::put(const uint64_t key, const unsigned int symmetry, const std::vector<float>& probabilities, const float value) {
+	Shard& shard = getShard(key);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	unsigned int index;
+	const auto found = shard.indices.find(key);
+	if (found != shard.indices.end()) {
+		index = found->second;
+	} else if (shard.entries.size() < shardCapacity) {
+		index = static_cast<unsigned int>(shard.entries.size());
+		shard.entries.emplace_back();
+		shard.priors.resize(shard.priors.size() + NUM_MOVES<SIDE_LENGTH>);
+		shard.indices.emplace(key, index);
+	} else {
+		//Sweeps the clock hand past recently used entries, clearing their mark, until it reaches one that was not used
+		while (shard.entries[shard.hand].referenced) {
+			shard.entries[shard.hand].referenced = false;
+			shard.hand = (shard.hand + 1) % shardCapacity;
+		}
+		index = shard.hand;
+		shard.hand = (shard.hand + 1) % shardCapacity;
+
+		shard.indices.erase(shard.entries[index].key);
+		shard.indices.emplace(key, index);
+	}
+
+	Entry& entry = shard.entries[index];
+	entry.key = key;
+	entry.value = value;
+	entry.referenced = false;
+	applySymmetry<SIDE_LENGTH>(probabilities.data(), symmetry, shard.priors.data() + static_cast<size_t>(index) * NUM_MOVES<SIDE_LENGTH>);
+}
+
+template <unsigned int SIDE_LENGTH>
+void EvaluationCache<SIDE_LENGTH>::clear() {
+	for (Shard& shard : shards) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.indices.clear();
+		shard.entries.clear();
+		shard.priors.clear();
+		shard.hand = 0;
+	}
+	hits = 0;
+	misses = 0;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned long long EvaluationCache<SIDE_LENGTH>::getHits() const {
+	return hits;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned long long EvaluationCache<SIDE_LENGTH>::getMisses() const {
+	return misses;
+}
+
+template <unsigned int SIDE_LENGTH>
+typename EvaluationCache<SIDE_LENGTH>::Shard& EvaluationCache<SIDE_LENGTH>::getShard(const uint64_t key) {
+	//Uses the high bits since the low bits pick the bucket within the shard's map
+	return shards[(key >> 32) % SHARD_COUNT];
+}
+
+template class EvaluationCache<5>;
+template class EvaluationCache<7>;
+template class EvaluationCache<9>;
+template class EvaluationCache<13>;
@@ -0,0 +1,147 @@
+#ifndef EVALUATION_CACHE_H
+#define EVALUATION_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../game/GameState.h"
+
+/**
+ * @brief Bounded cache of neural network evaluations keyed by everything the neural network is given about a game state, kept across searches so positions seen before skip the neural network
+ *
+ * Entries are split into shards that each have their own lock, so several search threads can use the cache at once. When a shard is full, an entry is replaced using the clock algorithm, which gives entries used since the clock hand last passed them another chance.
+ */
+template <unsigned int SIDE_LENGTH>
+class EvaluationCache {
+public:
+	/**
+	 * @brief Number of shards the entries are split into
+	 */
+	static constexpr unsigned int SHARD_COUNT = 16;
+
+	/**
+	 * @brief Constructs an empty cache with room for at least the given number of entries
+	 * @param capacity minimum number of entries
+	 */
+	explicit EvaluationCache(unsigned int capacity);
+
+	/**
+	 * @brief Returns the key of a game state, which covers exactly what toVector encodes: the player to move, the current board and the most recent previous boards
+	 *
+	 * The boards are first moved by whichever rotation or reflection gives the smallest key, so all eight symmetric variants of a game state share one entry.
+	 * @param gameState game state to get the key of
+	 * @param symmetry set to the symmetry the boards were moved by, which get and put need to orient move probabilities
+	 * @return key of the game state
+	 */
+	static uint64_t getKey(const GameState<SIDE_LENGTH>* gameState, unsigned int& symmetry);
+
+	/**
+	 * @brief Finds the evaluation of a game state
+	 * @param key key of the game state
+	 * @param symmetry symmetry given by getKey
+	 * @param probabilities set to the move probabilities given by the neural network in the game state's own orientation if found
+	 * @param value set to the value given by the neural network if found
+	 * @return whether the game state was found
+	 */
+	bool get(uint64_t key, unsigned int symmetry, std::vector<float>& probabilities, float& value);
+
+	/**
+	 * @brief Stores the evaluation of a game state, replacing an entry if its shard is full
+	 * @param key key of the game state
+	 * @param symmetry symmetry given by getKey
+	 * @param probabilities move probabilities given by the neural network in the game state's own orientation
+	 * @param value value given by the neural network
+	 */
+	void put(uint64_t key, unsigned int symmetry, const std::vector<float>& probabilities, float value);
+
+	/**
+	 * @brief Removes every entry, which is needed whenever the neural network changes, and resets the hit counters
+	 */
+	void clear();
+
+	/**
+	 * @brief Returns the number of lookups that found their game state since the cache was last cleared
+	 * @return number of hits
+	 */
+	[[nodiscard]] unsigned long long getHits() const;
+
+	/**
+	 * @brief Returns the number of lookups that did not find their game state since the cache was last cleared
+	 * @return number of misses
+	 */
+	[[nodiscard]] unsigned long long getMisses() const;
+private:
+	/**
+	 * @brief Evaluation of one game state
+	 */
+	struct Entry {
+		/**
+		 * @brief Key of the game state
+		 */
+		uint64_t key = 0;
+		/**
+		 * @brief Value given by the neural network
+		 */
+		float value = 0;
+		/**
+		 * @brief Whether the entry was used since the clock hand last passed it
+		 */
+		bool referenced = false;
+	};
+
+	/**
+	 * @brief Part of the cache with its own lock
+	 */
+	struct Shard {
+		/**
+		 * @brief Held while reading or changing the shard
+		 */
+		std::mutex mutex;
+		/**
+		 * @brief Index of the entry holding each key
+		 */
+		std::unordered_map<uint64_t, unsigned int> indices;
+		/**
+		 * @brief Entries in use, which grows up to the shard's capacity
+		 */
+		std::vector<Entry> entries;
+		/**
+		 * @brief Move probabilities of each entry one after the other, oriented like the boards the entry's key was taken from
+		 */
+		std::vector<float> priors;
+		/**
+		 * @brief Index of the next entry the clock looks at when replacing
+		 */
+		unsigned int hand = 0;
+	};
+
+	/**
+	 * @brief Returns the shard a key is stored in
+	 * @param key key of the game state
+	 * @return shard of the key
+	 */
+	Shard& getShard(uint64_t key);
+
+	/**
+	 * @brief Number of entries each shard can hold
+	 */
+	unsigned int shardCapacity;
+	/**
+	 * @brief Shards of the cache
+	 */
+	std::array<Shard, SHARD_COUNT> shards;
+	/**
+	 * @brief Number of lookups that found their game state
+	 */
+	std::atomic<unsigned long long> hits = 0;
+	/**
+	 * @brief Number of lookups that did not find their game state
+	 */
+	std::atomic<unsigned long long> misses = 0;
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "Example.h"
 
+#include <cmath>
 #include <unordered_map>
 
 #include "GameStateData.h"
@@ -51,9 +52,7 @@ std::vector<Example> Example::load(std::istream& in) {
 		}
 		
 		std::vector<std::string> elements = split(line, ' ');
-		for (unsigned int i = 0; i < GAME_STATE_DATA_LENGTH; i++) {
-			example.gameStateData.push_back(elements.at(0).at(i));
-		}
+		example.gameStateData.assign(elements.at(0).begin(), elements.at(0).end());
 		for (unsigned int i = 1; i < elements.size() - 1; i++) {
 			example.moveProbabilities.push_back(std::stof(elements.at(i)));
 		}
@@ -81,9 +80,7 @@ bool Example::safeLoad(std::istream& in, std::vector<Example>& examples) {
 		}
 		
 		std::vector<std::string> elements = split(line, ' ');
-		for (unsigned int i = 0; i < GAME_STATE_DATA_LENGTH; i++) {
-			example.gameStateData.push_back(elements.at(0).at(i));
-		}
+		example.gameStateData.assign(elements.at(0).begin(), elements.at(0).end());
 		for (unsigned int i = 1; i < elements.size() - 1; i++) {
 			example.moveProbabilities.push_back(std::stof(elements.at(i)));
 		}
@@ -140,9 +137,7 @@ void Example::saveAverage(std::istream& in, std::ostream& out) {
 		}
 		
 		std::vector<std::string> elements = split(line, ' ');
-		for (unsigned int i = 0; i < GAME_STATE_DATA_LENGTH; i++) {
-			state.push_back(elements.at(0).at(i));
-		}
+		state = elements.at(0);
 		for (unsigned int i = 1; i < elements.size() - 1; i++) {
 			result.first.emplace_back(std::stof(elements.at(i)));
 		}
@@ -164,7 +159,7 @@ void Example::saveAverage(std::istream& in, std::ostream& out) {
 		out << ' ';
 
 		std::vector<float> totalProbabilities;
-		totalProbabilities.resize(NUM_MOVES, 0);
+		totalProbabilities.resize(results.front().first.size(), 0);
 		float totalValue = 0;
 		for (const auto& [moveProbabilities, value] : results) {
 			for (size_t move = 0; move < moveProbabilities.size(); move++) {
@@ -209,7 +204,28 @@ float Example::getValue() const {
 }
 
 void Example::display(std::ostream& out) const {
-	GameState* gameState = getGameState(gameStateData);
+	//Side length is found from the number of cells in each plane
+	switch (static_cast<unsigned int>(std::lround(std::sqrt(gameStateData.size() / GAME_STATE_DATA_PLANES)))) {
+		case 5:
+			display<5>(out);
+			break;
+		case 7:
+			display<7>(out);
+			break;
+		case 9:
+			display<9>(out);
+			break;
+		case 13:
+			display<13>(out);
+			break;
+		default:
+			out << "Unsupported board size" << '\n';
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void Example::display(std::ostream& out) const {
+	GameState<SIDE_LENGTH>* gameState = getGameState<SIDE_LENGTH>(gameStateData);
 	out << *gameState;
 
 	for (const int move : *gameState->getValidMoves()) {
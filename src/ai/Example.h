@@ -74,6 +74,13 @@ public:
 	 */
 	void display(std::ostream& out) const;
 private:
+	/**
+	 * @brief Prints self to stream as a game state with the given side length
+	 * @param out stream to print to
+	 */
+	template <unsigned int SIDE_LENGTH>
+	void display(std::ostream& out) const;
+
 	/**
 	 * @brief Game state in vector form
 	 */
@@ -1,27 +1,38 @@
+#include <array>
+
 #include "GameStateData.h"
 
-std::vector<uint8_t> toVector(const GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+std::vector<uint8_t> toVector(const GameState<SIDE_LENGTH>* gameState) {
 	std::vector<uint8_t> data;
-	data.reserve(GAME_STATE_DATA_LENGTH);
+	data.reserve(GAME_STATE_DATA_LENGTH<SIDE_LENGTH>);
 	const bool white = gameState->getColor() == 'O';
-	const std::string* board = gameState->getBoard();
-	const std::vector<std::string>* previousBoards = gameState->getPreviousBoards();
-	for (unsigned int i = 0; i < GAME_STATE_DATA_SIZE[0]; i++) {
-		for (unsigned int j = 0; j < GAME_STATE_DATA_SIZE[1]; j++) {
-			for (unsigned int k = 0; k < GAME_STATE_DATA_SIZE[2]; k++) {
+	const Position<SIDE_LENGTH>* position = gameState->getPosition();
+
+	//Collects the most recent previous boards from the history
+	constexpr unsigned int MAX_PREVIOUS_POSITIONS = GAME_STATE_DATA_PLANES / 2 - 2;
+	std::array<const Position<SIDE_LENGTH>*, MAX_PREVIOUS_POSITIONS> previousPositions{};
+	unsigned int previousCount = 0;
+	for (const PositionHistory<SIDE_LENGTH>* entry = gameState->getHistory(); entry != nullptr && previousCount < MAX_PREVIOUS_POSITIONS; entry = entry->getPrevious()) {
+		previousPositions[previousCount++] = &entry->getPosition();
+	}
+
+	for (unsigned int i = 0; i < GAME_STATE_DATA_SIZE<SIDE_LENGTH>[0]; i++) {
+		for (unsigned int j = 0; j < GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1]; j++) {
+			for (unsigned int k = 0; k < GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2]; k++) {
 				if (i == 0) {
 					//Current player's color
 					data.push_back(white);
 				} else if (i == 1) {
 					//Blocked spaces
-					data.push_back((*board)[j * SIDE_LENGTH + k] == '#');
+					data.push_back(position->walls.test(j * SIDE_LENGTH + k));
 				} else if (i % 2 == 0) {
 					if (i / 2 == 1) {
 						//Current board's white spaces
-						data.push_back((*board)[j * SIDE_LENGTH + k] == 'O');
-					} else if (i / 2 - 2 < previousBoards->size()) {
+						data.push_back(position->white.test(j * SIDE_LENGTH + k));
+					} else if (i / 2 - 2 < previousCount) {
 						//Previous board's white spaces
-						data.push_back((*previousBoards)[previousBoards->size() - i / 2 + 1][j * SIDE_LENGTH + k] == 'O');
+						data.push_back(previousPositions[i / 2 - 2]->white.test(j * SIDE_LENGTH + k));
 					} else {
 						//Non existent
 						data.push_back(2);
@@ -29,10 +40,10 @@ std::vector<uint8_t> toVector(const GameState* gameState) {
 				} else {
 					if (i / 2 == 1) {
 						//Current board's black spaces
-						data.push_back((*board)[j * SIDE_LENGTH + k] == 'X');
-					} else if (i / 2 - 2 < previousBoards->size()) {
+						data.push_back(position->black.test(j * SIDE_LENGTH + k));
+					} else if (i / 2 - 2 < previousCount) {
 						//Previous board's black spaces
-						data.push_back((*previousBoards)[previousBoards->size() - i / 2 + 1][j * SIDE_LENGTH + k] == 'X');
+						data.push_back(previousPositions[i / 2 - 2]->black.test(j * SIDE_LENGTH + k));
 					} else {
 						//Non existent
 						data.push_back(2);
@@ -45,26 +56,27 @@ std::vector<uint8_t> toVector(const GameState* gameState) {
 	return data;
 }
 
-GameState* getGameState(const std::vector<uint8_t>& data) {
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>* getGameState(const std::vector<uint8_t>& data) {
 	const bool color = data.at(0);
 	std::string board;
-	for (unsigned int i = 0; i < AREA; i++) {
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH>; i++) {
 		board.push_back('.');
 	}
 
 	for (unsigned int i = 1; i <= 3; i++) {
-		for (unsigned int j = 0; j < GAME_STATE_DATA_SIZE[1]; j++) {
-			for (unsigned int k = 0; k < GAME_STATE_DATA_SIZE[2]; k++) {
+		for (unsigned int j = 0; j < GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1]; j++) {
+			for (unsigned int k = 0; k < GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2]; k++) {
 				if (i == 1) {
-					if (data.at(i * GAME_STATE_DATA_SIZE[1] * GAME_STATE_DATA_SIZE[2] + j * GAME_STATE_DATA_SIZE[2] + k)) {
+					if (data.at(i * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1] * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2] + j * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2] + k)) {
 						board.at(j * SIDE_LENGTH + k) = '#';
 					}
 				} else if (i == 2) {
-					if (data.at(i * GAME_STATE_DATA_SIZE[1] * GAME_STATE_DATA_SIZE[2] + j * GAME_STATE_DATA_SIZE[2] + k)) {
+					if (data.at(i * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1] * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2] + j * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2] + k)) {
 						board.at(j * SIDE_LENGTH + k) = 'O';
 					}
 				} else if (i == 3) {
-					if (data.at(i * GAME_STATE_DATA_SIZE[1] * GAME_STATE_DATA_SIZE[2] + j * GAME_STATE_DATA_SIZE[2] + k)) {
+					if (data.at(i * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1] * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2] + j * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2] + k)) {
 						board.at(j * SIDE_LENGTH + k) = 'X';
 					}
 				}
@@ -72,5 +84,15 @@ GameState* getGameState(const std::vector<uint8_t>& data) {
 		}
 	}
 
-	return GameState::newGame(color ? 'O' : 'X', board);
+	return GameState<SIDE_LENGTH>::newGame(color ? 'O' : 'X', board);
 }
+
+template std::vector<uint8_t> toVector(const GameState<5>* gameState);
+template std::vector<uint8_t> toVector(const GameState<7>* gameState);
+template std::vector<uint8_t> toVector(const GameState<9>* gameState);
+template std::vector<uint8_t> toVector(const GameState<13>* gameState);
+
+template GameState<5>* getGameState<5>(const std::vector<uint8_t>& data);
+template GameState<7>* getGameState<7>(const std::vector<uint8_t>& data);
+template GameState<9>* getGameState<9>(const std::vector<uint8_t>& data);
+template GameState<13>* getGameState<13>(const std::vector<uint8_t>& data);
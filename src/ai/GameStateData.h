@@ -4,27 +4,35 @@
 #include "../game/GameState.h"
 #include "../game/GameStateConstants.h"
 
+/**
+ * @brief Number of planes in the vector representing a game state: current player, walls, and white and black pieces for the current and 7 previous boards
+ */
+constexpr int GAME_STATE_DATA_PLANES = 1 + 1 + 8 * 2;
 /**
  * @brief Size of vector representing game state
  */
-constexpr int GAME_STATE_DATA_SIZE[3] = {1 + 1 + 8 * 2, SIDE_LENGTH, SIDE_LENGTH};
+template <unsigned int SIDE_LENGTH>
+inline constexpr int GAME_STATE_DATA_SIZE[3] = {GAME_STATE_DATA_PLANES, SIDE_LENGTH, SIDE_LENGTH};
 /**
  * @brief Length of vector representing game state
  */
-constexpr int GAME_STATE_DATA_LENGTH = GAME_STATE_DATA_SIZE[0] * GAME_STATE_DATA_SIZE[1] * GAME_STATE_DATA_SIZE[2];
+template <unsigned int SIDE_LENGTH>
+inline constexpr int GAME_STATE_DATA_LENGTH = GAME_STATE_DATA_PLANES * SIDE_LENGTH * SIDE_LENGTH;
 	
 /**
  * @brief Represents a game state as a vector
  * @param gameState game state to convert
  * @return vector representation of game state
  */
-std::vector<uint8_t> toVector(const GameState* gameState);
+template <unsigned int SIDE_LENGTH>
+std::vector<uint8_t> toVector(const GameState<SIDE_LENGTH>* gameState);
 
 /**
  * @brief Converts game state data back into a game state ignoring previous boards
  * @param data vector representation of game state
  * @return game state
  */
-GameState* getGameState(const std::vector<uint8_t>& data);
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>* getGameState(const std::vector<uint8_t>& data);
 
 #endif
@@ -1,6 +1,15 @@
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "MCTSConstants.h"
+
 #include "MCTS.h"
 
-MCTS::MCTS(const unsigned int simulations) {
+template <unsigned int SIDE_LENGTH>
+MCTS<SIDE_LENGTH>::MCTS(const unsigned int simulations) {
 	if (simulations < 1) {
 		this->simulations = 1;
 	} else {
@@ -8,6 +17,198 @@ MCTS::MCTS(const unsigned int simulations) {
 	}
 }
 
-void MCTS::setSimulations(const unsigned int simulations) {
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::setSimulations(const unsigned int simulations) {
 	this->simulations = simulations;
-}
\ No newline at end of file
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::setEarlyStopping(const bool earlyStopping) {
+	this->earlyStopping = earlyStopping;
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::setThreads(const unsigned int threads) {
+	if (threads < 1) {
+		this->threads = 1;
+	} else {
+		this->threads = threads;
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::setNodeLimit(const size_t nodeLimit) {
+	this->nodeLimit = nodeLimit;
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::setStopped(const bool stopped) {
+	this->stopped = stopped;
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::setSeed(const uint64_t seed) {
+	rng.seed(seed);
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int MCTS<SIDE_LENGTH>::getBestMove(GameState<SIDE_LENGTH>* gameState, const std::chrono::milliseconds timeLimit, const unsigned int simulationLimit) {
+	const unsigned int defaultSimulations = simulations;
+	if (simulationLimit > 0) {
+		simulations = simulationLimit;
+	} else if (timeLimit.count() > 0) {
+		simulations = std::numeric_limits<unsigned int>::max();
+	}
+	if (timeLimit.count() > 0) {
+		deadline = std::chrono::steady_clock::now() + timeLimit;
+	}
+
+	const unsigned int bestMove = getBestMove(gameState);
+
+	simulations = defaultSimulations;
+	deadline = std::chrono::steady_clock::time_point::max();
+
+	return bestMove;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int MCTS<SIDE_LENGTH>::getSimulationsRun() const {
+	return simulationsRun;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int MCTS<SIDE_LENGTH>::getSimulationsSaved() const {
+	return simulationsSaved;
+}
+
+template <unsigned int SIDE_LENGTH>
+const SearchStats& MCTS<SIDE_LENGTH>::getStats() const {
+	return stats;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool MCTS<SIDE_LENGTH>::makeRoom(SearchTree<SIDE_LENGTH>& tree, const unsigned int treeCount) {
+	const size_t treeLimit = std::max<size_t>(nodeLimit / treeCount, 1);
+	if (nodeLimit == 0 || tree.getNodeCount() < treeLimit) {
+		return true;
+	}
+
+	prunedNodes.fetch_add(tree.prune(static_cast<size_t>(static_cast<double>(treeLimit) * PRUNE_FRACTION)), std::memory_order_relaxed);
+	return tree.getNodeCount() < treeLimit;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool MCTS<SIDE_LENGTH>::hasTime() const {
+	if (stopped.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	return deadline == std::chrono::steady_clock::time_point::max() || std::chrono::steady_clock::now() < deadline;
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::beginStats(const unsigned int simulationsReused) {
+	stats = SearchStats();
+	stats.simulationsReused = simulationsReused;
+	searchStart = std::chrono::steady_clock::now();
+	maxDepth = 0;
+	totalDepth = 0;
+	selectionNanoseconds = 0;
+	evaluationNanoseconds = 0;
+	transpositionLookups = 0;
+	transpositionHits = 0;
+	prunedNodes = 0;
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::recordSimulation(const unsigned int depth, const std::chrono::steady_clock::duration selection, const std::chrono::steady_clock::duration evaluation) {
+	//Relaxed since the totals are only read once every thread is done
+	totalDepth.fetch_add(depth, std::memory_order_relaxed);
+	unsigned int deepest = maxDepth.load(std::memory_order_relaxed);
+	while (depth > deepest && !maxDepth.compare_exchange_weak(deepest, depth, std::memory_order_relaxed)) {
+	}
+	selectionNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(selection).count(), std::memory_order_relaxed);
+	evaluationNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(evaluation).count(), std::memory_order_relaxed);
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::recordTransposition(const bool found) {
+	transpositionLookups.fetch_add(1, std::memory_order_relaxed);
+	if (found) {
+		transpositionHits.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void MCTS<SIDE_LENGTH>::endStats(const size_t treeNodes) {
+	stats.simulations = simulationsRun;
+	stats.simulationsSaved = simulationsSaved;
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+	stats.selectionSeconds = static_cast<double>(selectionNanoseconds) / 1e9;
+	stats.evaluationSeconds = static_cast<double>(evaluationNanoseconds) / 1e9;
+	stats.treeNodes = treeNodes;
+	stats.maxDepth = maxDepth;
+	stats.totalDepth = totalDepth;
+	stats.transpositionLookups = transpositionLookups;
+	stats.transpositionHits = transpositionHits;
+	stats.prunedNodes = prunedNodes;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int MCTS<SIDE_LENGTH>::runWorkers(const unsigned int count, Random& rng, const std::function<unsigned int(Random&)>& simulate, const std::function<bool(unsigned int)>& isDecided, SearchTree<SIDE_LENGTH>* tree) {
+	if (threads <= 1) {
+		unsigned int simulationCount = 0;
+		for (unsigned int i = 0; i < count && hasTime() && !(isDecided && isDecided(simulationCount)); i++) {
+			if (tree != nullptr) {
+				makeRoom(*tree);
+			}
+			simulationCount += simulate(rng);
+		}
+		return simulationCount;
+	}
+
+	//Each thread takes tasks from a shared counter until they run out, time is up, the search is decided or the tree is full
+	std::atomic<unsigned int> started = 0;
+	std::atomic<unsigned int> simulationCount = 0;
+	bool limited = tree != nullptr && nodeLimit > 0;
+	const auto isFull = [&]() {
+		return limited && tree->getNodeCount() >= nodeLimit;
+	};
+	const auto work = [&](Random& workerRng) {
+		while (hasTime() && !(isDecided && isDecided(simulationCount)) && !isFull() && started.fetch_add(1) < count) {
+			simulationCount += simulate(workerRng);
+		}
+	};
+
+	//Seeds every thread's generator up front so no generator is shared
+	std::vector<Random> workerRngs;
+	workerRngs.reserve(threads);
+	for (unsigned int i = 0; i < threads; i++) {
+		workerRngs.emplace_back(rng.split());
+	}
+
+	while (true) {
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+		for (unsigned int i = 1; i < threads; i++) {
+			workers.emplace_back(work, std::ref(workerRngs[i]));
+		}
+		work(workerRngs[0]);
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+
+		if (!isFull() || started >= count || !hasTime() || (isDecided && isDecided(simulationCount))) {
+			break;
+		}
+		//Every thread has stopped, so the tree can be pruned before carrying on, with a tree that cannot be pruned searched past the limit
+		limited = makeRoom(*tree);
+	}
+
+	return simulationCount;
+}
+
+template class MCTS<5>;
+template class MCTS<7>;
+template class MCTS<9>;
+template class MCTS<13>;
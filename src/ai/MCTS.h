@@ -1,8 +1,17 @@
 #ifndef MCTS_H
 #define MCTS_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+
 #include "../game/GameState.h"
+#include "../game/Random.h"
+
+#include "SearchStats.h"
+#include "SearchTree.h"
 
+template <unsigned int SIDE_LENGTH>
 class MCTS {
 public:
 	/**
@@ -11,26 +20,55 @@ public:
 	 */
 	explicit MCTS(unsigned int simulations);
 
+	virtual ~MCTS() = default;
+
 	/**
 	 * @brief Returns the average value of a game state
 	 * @param gameState game state to evaluate
 	 * @return the average value of a game state
 	 */
-	virtual float getMoveValue(const GameState* gameState) = 0;
+	virtual float getMoveValue(const GameState<SIDE_LENGTH>* gameState) = 0;
 
 	/**
 	 * @brief Runs simulations on given game state and returns move probabilities corresponding to the number of times each move was visited
 	 * @param gameState game state to start simulations on
 	 * @return list of probabilities for each move
 	 */
-	virtual std::vector<float> getMoveProbabilities(GameState* gameState) = 0;
+	virtual std::vector<float> getMoveProbabilities(GameState<SIDE_LENGTH>* gameState) = 0;
 
 	/**
 	 * @brief Runs simulations on given game state and returns the best move
 	 * @param gameState game state to start simulations on
 	 * @return index of best move
 	 */
-	virtual unsigned int getBestMove(GameState* gameState) = 0;
+	virtual unsigned int getBestMove(GameState<SIDE_LENGTH>* gameState) = 0;
+
+	/**
+	 * @brief Runs simulations on given game state until the time limit passes or the simulation limit is reached, whichever comes first, and returns the best move found so far, using the set number of simulations if neither limit is given
+	 * @param gameState game state to start simulations on
+	 * @param timeLimit longest time to search for, or 0 for no time limit
+	 * @param simulationLimit most simulations to run, or 0 for no simulation limit
+	 * @return index of best move
+	 */
+	unsigned int getBestMove(GameState<SIDE_LENGTH>* gameState, std::chrono::milliseconds timeLimit, unsigned int simulationLimit);
+
+	/**
+	 * @brief Returns the number of simulations the last search ran, not counting simulations kept from the search before it
+	 * @return number of simulations run
+	 */
+	[[nodiscard]] unsigned int getSimulationsRun() const;
+
+	/**
+	 * @brief Returns the number of simulations the last search skipped because its best move was already decided
+	 * @return number of simulations saved
+	 */
+	[[nodiscard]] unsigned int getSimulationsSaved() const;
+
+	/**
+	 * @brief Returns what the last search did, such as its speed, tree size, depth and where its time went
+	 * @return statistics of the last search
+	 */
+	[[nodiscard]] const SearchStats& getStats() const;
 
 	/**
 	 * @brief Sets the number of simulations with a minimum of 1
@@ -38,15 +76,182 @@ public:
 	 */
 	void setSimulations(unsigned int simulations);
 
+	/**
+	 * @brief Sets the number of threads searching the tree at once with a minimum of 1
+	 * @param threads number of threads to search with
+	 */
+	virtual void setThreads(unsigned int threads);
+
+	/**
+	 * @brief Sets whether searches stop once their best move is decided, which saves simulations without changing the best move but leaves the visit counts of the other moves less refined
+	 * @param earlyStopping whether to stop searches early
+	 */
+	void setEarlyStopping(bool earlyStopping);
+
+	/**
+	 * @brief Sets whether searches stop right away, which can be done from another thread to end a running search early
+	 * @param stopped whether searches should stop
+	 */
+	void setStopped(bool stopped);
+
+	/**
+	 * @brief Restarts the random numbers of searches from the given root seed, which every search thread's generator is split from, so searches on a single thread can be repeated exactly
+	 * @param seed root seed
+	 */
+	void setSeed(uint64_t seed);
+
+	/**
+	 * @brief Sets the number of entries in the transposition table shared by nodes that reach the same position through different move orders, with 0 turning it off
+	 * @param size number of entries
+	 */
+	virtual void setTranspositionTableSize(unsigned int size) = 0;
+
+	/**
+	 * @brief Sets the most nodes a search tree can hold, so many searches can share a host with predictable memory use
+	 *
+	 * Once a search tree reaches the limit, its least visited subtrees are freed and the search carries on, rebuilding them if they turn out to matter. Each node takes roughly sizeof(GameState) plus 32 bytes per valid move. Simulations running when the limit is reached can add a few nodes past it.
+	 *
+	 * With a limit set, the search owns every game state more than one move below the root it is given and deletes them when pruning, so no other search can be given the same game tree and callers can only keep pointers to the root and its children.
+	 * @param nodeLimit most nodes in a search tree, or 0 for no limit
+	 */
+	void setNodeLimit(size_t nodeLimit);
+
+	/**
+	 * @brief Makes the child reached by the given move the root, keeping its subtree so the next search continues from it
+	 * @param moveNum index of the move played in the root's valid moves
+	 */
+	virtual void advance(unsigned int moveNum) = 0;
+
 	/**
 	 * @brief Resets MCTS tree
 	 */
 	virtual void reset() = 0;
 protected:
+	/**
+	 * @brief Runs the given number of tasks split between the search threads, with the calling thread taking part, stopping early once the deadline passes
+	 *
+	 * Given a tree, the threads also pause whenever it reaches the node limit while it is pruned, since no thread can be holding a node then.
+	 * @param count number of tasks to run
+	 * @param rng random number generator used by a single thread, or to seed one per thread
+	 * @param simulate runs one task using the random number generator it is given and returns the number of simulations it ran
+	 * @param isDecided given the number of simulations run so far before each task and returns whether the search can stop, or empty to never stop early
+	 * @param tree tree the tasks search, or nullptr to not keep any tree within the node limit
+	 * @return number of simulations run
+	 */
+	unsigned int runWorkers(unsigned int count, Random& rng, const std::function<unsigned int(Random&)>& simulate, const std::function<bool(unsigned int)>& isDecided = {}, SearchTree<SIDE_LENGTH>* tree = nullptr);
+
+	/**
+	 * @brief Prunes a tree that has reached its share of the node limit, which must be done while no thread is searching it
+	 * @param tree tree to prune
+	 * @param treeCount number of trees the search splits the node limit between
+	 * @return whether the tree is now under its share of the node limit, which it cannot be if the root and its children alone reach it
+	 */
+	bool makeRoom(SearchTree<SIDE_LENGTH>& tree, unsigned int treeCount = 1);
+
+	/**
+	 * @brief Returns whether the current search still has time left, only reading the clock when there is a deadline
+	 * @return whether the search was not stopped and the deadline has not passed
+	 */
+	[[nodiscard]] bool hasTime() const;
+
+	/**
+	 * @brief Starts collecting statistics for a new search
+	 * @param simulationsReused number of simulations kept from the search before that count towards this one
+	 */
+	void beginStats(unsigned int simulationsReused);
+
+	/**
+	 * @brief Adds a simulation to the statistics of the current search, which can be done from several threads at once
+	 * @param depth number of moves from the root to the leaf
+	 * @param selection time spent selecting the leaf
+	 * @param evaluation time spent evaluating the leaf
+	 */
+	void recordSimulation(unsigned int depth, std::chrono::steady_clock::duration selection, std::chrono::steady_clock::duration evaluation);
+
+	/**
+	 * @brief Adds a new leaf looked up in the transposition table to the statistics of the current search, which can be done from several threads at once
+	 * @param found whether the leaf was found
+	 */
+	void recordTransposition(bool found);
+
+	/**
+	 * @brief Finishes the statistics of the current search once its simulations have been counted
+	 * @param treeNodes number of nodes in the tree
+	 */
+	void endStats(size_t treeNodes);
+
 	/**
 	 * @brief The number of simulations to perform each time MCTS is run
 	 */
 	unsigned int simulations;
+	/**
+	 * @brief The number of threads searching the tree at once
+	 */
+	unsigned int threads = 1;
+	/**
+	 * @brief The most nodes a search tree can hold, or 0 for no limit
+	 */
+	size_t nodeLimit = 0;
+	/**
+	 * @brief Whether searches stop right away, set from another thread
+	 */
+	std::atomic<bool> stopped = false;
+	/**
+	 * @brief Time the current search has to finish by
+	 */
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	/**
+	 * @brief The number of simulations the last search ran
+	 */
+	unsigned int simulationsRun = 0;
+	/**
+	 * @brief Whether searches stop once their best move is decided
+	 */
+	bool earlyStopping = false;
+	/**
+	 * @brief The number of simulations the last search skipped because its best move was already decided
+	 */
+	unsigned int simulationsSaved = 0;
+	/**
+	 * @brief Statistics of the last search
+	 */
+	SearchStats stats;
+	/**
+	 * @brief Time the current search started
+	 */
+	std::chrono::steady_clock::time_point searchStart;
+	/**
+	 * @brief Most moves from the root to a leaf in the current search
+	 */
+	std::atomic<unsigned int> maxDepth = 0;
+	/**
+	 * @brief Sum of the moves from the root to each leaf in the current search
+	 */
+	std::atomic<unsigned long long> totalDepth = 0;
+	/**
+	 * @brief Nanoseconds spent selecting leaves in the current search
+	 */
+	std::atomic<long long> selectionNanoseconds = 0;
+	/**
+	 * @brief Nanoseconds spent evaluating leaves in the current search
+	 */
+	std::atomic<long long> evaluationNanoseconds = 0;
+	/**
+	 * @brief Number of new leaves looked up in the transposition table in the current search
+	 */
+	std::atomic<unsigned long long> transpositionLookups = 0;
+	/**
+	 * @brief Number of new leaves found in the transposition table in the current search
+	 */
+	std::atomic<unsigned long long> transpositionHits = 0;
+	/**
+	 * @brief Number of nodes freed to stay within the node limit in the current search, which root parallel trees add to at once
+	 */
+	std::atomic<size_t> prunedNodes = 0;
+	/**
+	 * @brief Random number generator of the search, used by the calling thread and to seed one for each other thread
+	 */
+	Random rng;
 };
 
 #endif
\ No newline at end of file
@@ -5,6 +5,14 @@
  * @brief Multiplied by the exploration term in the calculation for selection score, higher values encourage exploration
  */
 constexpr float EXPLORATION_PARAMETER = 1.4f;
+/**
+ * @brief Replaces EXPLORATION_PARAMETER when BasicMCTS uses RAVE, which is lower since all moves as first values already spread visits between moves
+ */
+constexpr float RAVE_EXPLORATION_PARAMETER = 0.25f;
+/**
+ * @brief Suggested number of visits where a move's own value and its all moves as first value are weighted equally when using RAVE
+ */
+constexpr unsigned int RAVE_EQUIVALENCE = 1000;
 /**
  * @brief Used in creating a Dirichlet distribution, higher values encourage exploration
  */
@@ -13,5 +21,13 @@ constexpr float ALPHA = 1.0f;
  * @brief Used to scale how much the Dirichlet distribution affects move probabilities, higher values encourage exploration
  */
 constexpr float DIRICHLET_SCALAR = 0.25f;
+/**
+ * @brief Number of losses added to a child for each thread currently simulating past it, which steers other threads to different children
+ */
+constexpr unsigned int VIRTUAL_LOSS = 1;
+/**
+ * @brief Fraction of the node limit a full search tree is pruned down to, leaving room to grow before it has to be pruned again
+ */
+constexpr float PRUNE_FRACTION = 0.75f;
 
 #endif
\ No newline at end of file
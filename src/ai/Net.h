@@ -7,7 +7,6 @@
 
 #include "GameStateData.h"
 
-#include "../game/GameStateConstants.h"
 
 using namespace torch;
 
@@ -16,11 +15,16 @@ struct NetImpl : public nn::Module {
 	nn::BatchNorm3d bn1, bn2, bn3, bn4, bnP1, bnV1;
 	nn::Linear fcP1, fcP2, fcV1, fcV2;
 	nn::BatchNorm1d fcBnP1, fcBnV1;
+	/**
+	 * @brief Side length of the boards the net takes in
+	 */
+	int sideLength;
 
 	/**
-	 * @brief Constructor which initializes neural net layers
+	 * @brief Constructor which initializes neural net layers for boards with the given side length
+	 * @param sideLength side length of the boards the net takes in
 	 */
-	NetImpl() :
+	explicit NetImpl(const int sideLength) :
 			conv1(nn::Conv3dOptions(1, 64, 3).stride(1).padding(1)),
 			conv2(nn::Conv3dOptions(64, 64, 3).stride(1).padding(1)),
 			conv3(nn::Conv3dOptions(64, 64, 3).stride(1).padding(1)),
@@ -28,8 +32,9 @@ struct NetImpl : public nn::Module {
 			convP1(nn::Conv3dOptions(64, 64, 3).stride(1).padding(1)),
 			convV1(nn::Conv3dOptions(64, 64, 3).stride(1).padding(1)),
 			bn1(64), bn2(64), bn3(64), bn4(64), bnP1(64), bnV1(64),
-			fcP1(64 * GAME_STATE_DATA_LENGTH, 512), fcV1(64 * GAME_STATE_DATA_LENGTH, 512), fcP2(512, NUM_MOVES), fcV2(512, 1),
-			fcBnP1(512), fcBnV1(512)
+			fcP1(64 * GAME_STATE_DATA_PLANES * sideLength * sideLength, 512), fcV1(64 * GAME_STATE_DATA_PLANES * sideLength * sideLength, 512),
+			fcP2(512, sideLength * sideLength + 1), fcV2(512, 1),
+			fcBnP1(512), fcBnV1(512), sideLength(sideLength)
 	{
 		register_module("conv1",conv1);
 		register_module("conv2",conv2);
@@ -57,20 +62,21 @@ struct NetImpl : public nn::Module {
 	 * @return vector containing a vector with lists of probabilities for moves and a vector with values for the corresponding game states
 	 */
 	std::vector<Tensor> forward(Tensor tensor){
-		tensor = tensor.view({-1, 1, GAME_STATE_DATA_SIZE[0], GAME_STATE_DATA_SIZE[1], GAME_STATE_DATA_SIZE[2]}); //batchSize by GAME_STATE_DATA_SIZE[0] by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
+		const int gameStateDataLength = GAME_STATE_DATA_PLANES * sideLength * sideLength;
+		tensor = tensor.view({-1, 1, GAME_STATE_DATA_PLANES, sideLength, sideLength}); //batchSize by GAME_STATE_DATA_PLANES by sideLength by sideLength
 
-		tensor = relu(bn1(conv1(tensor))); //batchSize by 64 by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
-		tensor = relu(bn2(conv2(tensor))); //batchSize by 64 by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
-		tensor = relu(bn3(conv3(tensor))); //batchSize by 64 by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
-		tensor = relu(bn4(conv4(tensor))); //batchSize by 64 by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
+		tensor = relu(bn1(conv1(tensor))); //batchSize by 64 by sideLength by sideLength
+		tensor = relu(bn2(conv2(tensor))); //batchSize by 64 by sideLength by sideLength
+		tensor = relu(bn3(conv3(tensor))); //batchSize by 64 by sideLength by sideLength
+		tensor = relu(bn4(conv4(tensor))); //batchSize by 64 by sideLength by sideLength
 
-		Tensor probabilities = relu(bnP1(convP1(tensor))); //batchSize by 64 by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
-		probabilities = probabilities.view({-1, 64 * GAME_STATE_DATA_LENGTH}); //batchSize by 64 * GAME_STATE_DATA_LENGTH
+		Tensor probabilities = relu(bnP1(convP1(tensor))); //batchSize by 64 by sideLength by sideLength
+		probabilities = probabilities.view({-1, 64 * gameStateDataLength}); //batchSize by 64 * gameStateDataLength
 		probabilities = dropout(relu(fcBnP1(fcP1(probabilities))), 0.1, is_training()); //batchSize by 512
 		probabilities = fcP2(probabilities).nan_to_num(); //batchSize by NUM_MOVES
 
-		Tensor value = relu(bnV1(convV1(tensor))); //batchSize by 64 by GAME_STATE_DATA_SIZE[1] by GAME_STATE_DATA_SIZE[2]
-		value = value.view({-1, 64 * GAME_STATE_DATA_LENGTH}); //batchSize by 64 * GAME_STATE_DATA_LENGTH
+		Tensor value = relu(bnV1(convV1(tensor))); //batchSize by 64 by sideLength by sideLength
+		value = value.view({-1, 64 * gameStateDataLength}); //batchSize by 64 * gameStateDataLength
 		value = dropout(relu(fcBnV1(fcV1(value))), 0.1, is_training()); //batchSize by 512
 		value = fcV2(value).nan_to_num(); //batchSize by 1
 
@@ -4,29 +4,106 @@
 
 #include "NeuralNetwork.h"
 
-std::pair<std::vector<float>, float> NeuralNetwork::predict(const GameState* gameState) {
+template <unsigned int SIDE_LENGTH>
+NeuralNetwork<SIDE_LENGTH>::NeuralNetwork() : net(static_cast<int>(SIDE_LENGTH)) {
+}
+
+template <unsigned int SIDE_LENGTH>
+std::pair<std::vector<float>, float> NeuralNetwork<SIDE_LENGTH>::predict(const GameState<SIDE_LENGTH>* gameState) {
+	return predict(std::vector<const GameState<SIDE_LENGTH>*>{gameState}).front();
+}
+
+template <unsigned int SIDE_LENGTH>
+std::vector<std::pair<std::vector<float>, float>> NeuralNetwork<SIDE_LENGTH>::predict(const std::vector<const GameState<SIDE_LENGTH>*>& gameStates) {
+	//Only runs the game states the cache does not have through the neural net
+	std::vector<std::pair<std::vector<float>, float>> predictions(gameStates.size());
+	std::vector<uint64_t> keys;
+	std::vector<unsigned int> symmetries;
+	std::vector<size_t> uncached;
+	uncached.reserve(gameStates.size());
+	if (cache != nullptr) {
+		keys.resize(gameStates.size());
+		symmetries.resize(gameStates.size());
+		for (size_t i = 0; i < gameStates.size(); i++) {
+			keys[i] = EvaluationCache<SIDE_LENGTH>::getKey(gameStates[i], symmetries[i]);
+			if (!cache->get(keys[i], symmetries[i], predictions[i].first, predictions[i].second)) {
+				uncached.push_back(i);
+			}
+		}
+	} else {
+		for (size_t i = 0; i < gameStates.size(); i++) {
+			uncached.push_back(i);
+		}
+	}
+	if (uncached.empty()) {
+		return predictions;
+	}
+
 	Device device = torch::cuda::is_available() ? torch::Device(kCUDA) : Device(kCPU);
 	
 	NoGradGuard noGrad;
-	net.eval();
-	net.to(device);
+	if (!readyToPredict.load(std::memory_order_acquire)) {
+		//Switches modes once so search threads can run the neural net at the same time
+		std::lock_guard<std::mutex> lock(predictMutex);
+		if (!readyToPredict.load(std::memory_order_relaxed)) {
+			net.eval();
+			net.to(device);
+			readyToPredict.store(true, std::memory_order_release);
+		}
+	}
 
-	std::vector<uint8_t> binaryGameState = toVector(gameState);
-	std::vector<float> gameStateData(binaryGameState.begin(), binaryGameState.end());
+	const auto batchSize = static_cast<int>(uncached.size());
+	std::vector<float> gameStateData;
+	gameStateData.reserve(uncached.size() * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[0] * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1] * GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2]);
+	for (const size_t index : uncached) {
+		std::vector<uint8_t> binaryGameState = toVector(gameStates[index]);
+		gameStateData.insert(gameStateData.end(), binaryGameState.begin(), binaryGameState.end());
+	}
 
-	const Tensor tGameState = torch::from_blob(gameStateData.data(), {GAME_STATE_DATA_SIZE[0], GAME_STATE_DATA_SIZE[1], GAME_STATE_DATA_SIZE[2]}).clone().to(device);
+	const Tensor tGameStates = torch::from_blob(gameStateData.data(), {batchSize, GAME_STATE_DATA_SIZE<SIDE_LENGTH>[0], GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1], GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2]}).clone().to(device);
 	
-	std::vector<Tensor> results = net.forward(tGameState);
+	std::vector<Tensor> results = net.forward(tGameStates);
 	results.at(0) = results.at(0).exp();
-	const Tensor tProbabilities = results.at(0).cpu();
-	std::vector<float> probabilities(tProbabilities.data_ptr<float>(), tProbabilities.data_ptr<float>() + tProbabilities.numel());
+	const Tensor tProbabilities = results.at(0).cpu().contiguous();
+	const Tensor tValues = results.at(1).cpu().contiguous();
 
-	return {probabilities, results.at(1).item<float>()};
+	//Splits the batch back into one result per game state
+	const float* probabilities = tProbabilities.data_ptr<float>();
+	const float* values = tValues.data_ptr<float>();
+	for (int i = 0; i < batchSize; i++) {
+		std::pair<std::vector<float>, float>& prediction = predictions[uncached[i]];
+		prediction.first.assign(probabilities + i * NUM_MOVES<SIDE_LENGTH>, probabilities + (i + 1) * NUM_MOVES<SIDE_LENGTH>);
+		prediction.second = values[i];
+		if (cache != nullptr) {
+			cache->put(keys[uncached[i]], symmetries[uncached[i]], prediction.first, prediction.second);
+		}
+	}
+
+	return predictions;
+}
+
+template <unsigned int SIDE_LENGTH>
+void NeuralNetwork<SIDE_LENGTH>::setCacheSize(const unsigned int size) {
+	if (size == 0) {
+		cache = nullptr;
+	} else {
+		cache = std::make_unique<EvaluationCache<SIDE_LENGTH>>(size);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+const EvaluationCache<SIDE_LENGTH>* NeuralNetwork<SIDE_LENGTH>::getCache() const {
+	return cache.get();
 }
 
-void NeuralNetwork::train(std::vector<Example>& examples, const int batchSize) {
+template <unsigned int SIDE_LENGTH>
+void NeuralNetwork<SIDE_LENGTH>::train(std::vector<Example>& examples, const int batchSize) {
 	torch::Device device = torch::cuda::is_available() ? torch::Device(torch::kCUDA) : torch::Device(torch::kCPU);
 	torch::optim::Adam optimizer(net.parameters());
+	readyToPredict = false;
+	if (cache != nullptr) {
+		cache->clear();
+	}
 	net.train();
 	net.to(device);
 
@@ -47,8 +124,8 @@ void NeuralNetwork::train(std::vector<Example>& examples, const int batchSize) {
 			values.push_back(examples.at(index).getValue());
 		}
 		
-		const Tensor tGames = torch::from_blob(games.data(), {batchSize, GAME_STATE_DATA_SIZE[0], GAME_STATE_DATA_SIZE[1], GAME_STATE_DATA_SIZE[2]}).clone().to(device);
-		Tensor tProbabilities = torch::from_blob(probabilities.data(), {batchSize, NUM_MOVES}).clone().to(device);
+		const Tensor tGames = torch::from_blob(games.data(), {batchSize, GAME_STATE_DATA_SIZE<SIDE_LENGTH>[0], GAME_STATE_DATA_SIZE<SIDE_LENGTH>[1], GAME_STATE_DATA_SIZE<SIDE_LENGTH>[2]}).clone().to(device);
+		Tensor tProbabilities = torch::from_blob(probabilities.data(), {batchSize, NUM_MOVES<SIDE_LENGTH>}).clone().to(device);
 		Tensor tValues = torch::from_blob(values.data(), {batchSize, 1}).clone().to(device);
 		
 		std::vector<Tensor> results = net.forward(tGames);
@@ -63,12 +140,17 @@ void NeuralNetwork::train(std::vector<Example>& examples, const int batchSize) {
 	}
 }
 
-bool NeuralNetwork::load(const std::string& inputFilename) {
+template <unsigned int SIDE_LENGTH>
+bool NeuralNetwork<SIDE_LENGTH>::load(const std::string& inputFilename) {
 	try {
 		serialize::InputArchive inputArchive;
 		torch::Device device = torch::cuda::is_available() ? torch::Device(torch::kCUDA) : torch::Device(torch::kCPU);
 		inputArchive.load_from(inputFilename, device);
 		net.load(inputArchive);
+		readyToPredict = false;
+		if (cache != nullptr) {
+			cache->clear();
+		}
 	} catch (...) {
 		return false;
 	}
@@ -76,7 +158,8 @@ bool NeuralNetwork::load(const std::string& inputFilename) {
 	return true;
 }
 
-bool NeuralNetwork::save(const std::string& outputFilename) const {
+template <unsigned int SIDE_LENGTH>
+bool NeuralNetwork<SIDE_LENGTH>::save(const std::string& outputFilename) const {
 	try {
 		serialize::OutputArchive outputArchive;
 		net.save(outputArchive);
@@ -86,4 +169,14 @@ bool NeuralNetwork::save(const std::string& outputFilename) const {
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+template <unsigned int SIDE_LENGTH>
+void NeuralNetwork<SIDE_LENGTH>::setSeed(const uint64_t seed) {
+	rng.seed(seed);
+}
+
+template class NeuralNetwork<5>;
+template class NeuralNetwork<7>;
+template class NeuralNetwork<9>;
+template class NeuralNetwork<13>;
@@ -3,31 +3,60 @@
 
 #include <torch/torch.h>
 
-#include <random>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 #include "Net.h"
 #include "Example.h"
+#include "EvaluationCache.h"
 
 #include "../game/GameState.h"
+#include "../game/Random.h"
 
+template <unsigned int SIDE_LENGTH>
 class NeuralNetwork {
 public:
 	/**
-	 * @brief Runs given state through neural net and returns the results
+	 * @brief Constructs a neural network for boards with the given side length
+	 */
+	NeuralNetwork();
+
+	/**
+	 * @brief Runs given state through neural net and returns the results, using the evaluation cache if it has the state, which can be done from several threads at once
 	 * @param gameState game state to run through neural net  
 	 * @return pairs with the move probabilities of the given board and the value of the given board
 	 */
-	std::pair<std::vector<float>, float> predict(const GameState* gameState);
+	std::pair<std::vector<float>, float> predict(const GameState<SIDE_LENGTH>* gameState);
+
+	/**
+	 * @brief Runs given states through neural net in one batch and returns the results in the same order, leaving out states the evaluation cache has, which can be done from several threads at once
+	 * @param gameStates game states to run through neural net
+	 * @return pairs with the move probabilities and the value of each given board
+	 */
+	std::vector<std::pair<std::vector<float>, float>> predict(const std::vector<const GameState<SIDE_LENGTH>*>& gameStates);
 
 	/**
-	 * @brief Trains neural net on given examples using the given batch size
+	 * @brief Sets the number of evaluations kept in a cache across searches, with 0 turning it off
+	 * @param size number of evaluations
+	 */
+	void setCacheSize(unsigned int size);
+
+	/**
+	 * @brief Returns the evaluation cache, which has the hit counters
+	 * @return evaluation cache or null if turned off
+	 */
+	[[nodiscard]] const EvaluationCache<SIDE_LENGTH>* getCache() const;
+
+	/**
+	 * @brief Trains neural net on given examples using the given batch size, clearing the evaluation cache
 	 * @param examples vector of examples
 	 * @param batchSize number of examples to include in each batch
 	 */
 	void train(std::vector<Example>& examples, int batchSize);
 
 	/**
-	 * @brief Loads neural net from file path and returns whether it was successful
+	 * @brief Loads neural net from file path and returns whether it was successful, clearing the evaluation cache
 	 * @param inputFilename file path to load neural net from 
 	 * @return whether the neural net loaded successfully 
 	 */
@@ -39,19 +68,33 @@ public:
 	 * @return whether the neural net saved successfully 
 	 */
 	bool save(const std::string& outputFilename) const;
+
+	/**
+	 * @brief Restarts the random numbers used while training from the given seed so training can be repeated
+	 * @param seed seed to start from
+	 */
+	void setSeed(uint64_t seed);
 private:
 	/**
 	 * @brief Neural net to run boards through
 	 */
 	NetImpl net;
 	/**
-     * @brief Used to seed rng
-     */
-	inline static std::random_device seeder;
-	/** 
-	 * @brief Used to generate random unsigned 64 bit integers
+	 * @brief Whether the neural net is in evaluation mode on the device predictions run on
+	 */
+	std::atomic<bool> readyToPredict = false;
+	/**
+	 * @brief Held while preparing the neural net for predictions
+	 */
+	std::mutex predictMutex;
+	/**
+	 * @brief Evaluations of recently seen game states, or null if turned off
+	 */
+	std::unique_ptr<EvaluationCache<SIDE_LENGTH>> cache;
+	/**
+	 * @brief Used to shuffle examples while training
 	 */
-	inline static std::mt19937_64 rng = std::mt19937_64(seeder());
+	Random rng;
 };
 
 #endif
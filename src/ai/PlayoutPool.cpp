@@ -0,0 +1,99 @@
+#include "PlayoutPool.h"
+
+template <unsigned int SIDE_LENGTH>
+PlayoutPool<SIDE_LENGTH>::PlayoutPool(const unsigned int threads, Random& rng, const Playout playout) : playoutFunction(playout) {
+	//Seeds every thread's generator up front so no generator is shared
+	workerRngs.reserve(threads > 1 ? threads - 1 : 0);
+	for (unsigned int i = 1; i < threads; i++) {
+		workerRngs.emplace_back(rng.split());
+	}
+
+	workers.reserve(workerRngs.size());
+	for (Random& workerRng : workerRngs) {
+		workers.emplace_back(&PlayoutPool::work, this, std::ref(workerRng));
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+PlayoutPool<SIDE_LENGTH>::~PlayoutPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+float PlayoutPool<SIDE_LENGTH>::playout(const GameState<SIDE_LENGTH>* gameState, Random& rng) {
+	if (workers.empty()) {
+		return playoutFunction(gameState, rng);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->gameState = gameState;
+		generation++;
+		remaining = static_cast<unsigned int>(workers.size());
+		totalValue = 0;
+	}
+	started.notify_all();
+
+	const float value = playoutFunction(gameState, rng);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] {
+		return remaining == 0;
+	});
+
+	return (totalValue + value) / static_cast<float>(workers.size() + 1);
+}
+
+template <unsigned int SIDE_LENGTH>
+void PlayoutPool<SIDE_LENGTH>::reseed(Random& rng) {
+	//The threads only use their generators after taking the lock for a new game state
+	std::lock_guard<std::mutex> lock(mutex);
+	for (Random& workerRng : workerRngs) {
+		workerRng = rng.split();
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int PlayoutPool<SIDE_LENGTH>::getThreads() const {
+	return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+template <unsigned int SIDE_LENGTH>
+void PlayoutPool<SIDE_LENGTH>::work(Random& workerRng) {
+	unsigned int seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		started.wait(lock, [&] {
+			return stopping || generation != seenGeneration;
+		});
+		if (stopping) {
+			return;
+		}
+		seenGeneration = generation;
+
+		//Plays out without the lock so the threads run at the same time
+		const GameState<SIDE_LENGTH>* current = gameState;
+		lock.unlock();
+		const float value = playoutFunction(current, workerRng);
+		lock.lock();
+
+		totalValue += value;
+		remaining--;
+		if (remaining == 0) {
+			finished.notify_one();
+		}
+	}
+}
+
+template class PlayoutPool<5>;
+template class PlayoutPool<7>;
+template class PlayoutPool<9>;
+template class PlayoutPool<13>;
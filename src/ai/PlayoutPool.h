@@ -0,0 +1,116 @@
+#ifndef PLAYOUT_POOL_H
+#define PLAYOUT_POOL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../game/GameState.h"
+#include "../game/Random.h"
+
+/**
+ * @brief Threads that play out the same game state at once for leaf parallel searches, each with its own random number generator
+ *
+ * The threads are started once for a search and wait between leaves, so handing them a leaf only costs a lock and a wake up.
+ */
+template <unsigned int SIDE_LENGTH>
+class PlayoutPool {
+public:
+	/**
+	 * @brief Plays out a game state to its end and returns the end state value
+	 */
+	using Playout = float (*)(const GameState<SIDE_LENGTH>* gameState, Random& rng);
+
+	/**
+	 * @brief Starts the threads of the pool
+	 * @param threads number of playouts run for each game state, with the calling thread running one of them
+	 * @param rng random number generator used to seed one per thread
+	 * @param playout function used to play out game states
+	 */
+	PlayoutPool(unsigned int threads, Random& rng, Playout playout);
+
+	//Prevents copying/moving pools since the threads point to the pool
+	PlayoutPool(const PlayoutPool& other) = delete;
+	PlayoutPool& operator=(const PlayoutPool& other) = delete;
+	PlayoutPool(const PlayoutPool&& other) = delete;
+	PlayoutPool& operator=(const PlayoutPool&& other) = delete;
+
+	/**
+	 * @brief Stops the threads of the pool
+	 */
+	~PlayoutPool();
+
+	/**
+	 * @brief Plays out a game state once on every thread, which must not change until the playouts are done
+	 * @param gameState game state to play out
+	 * @param rng random number generator of the calling thread
+	 * @return average end state value
+	 */
+	float playout(const GameState<SIDE_LENGTH>* gameState, Random& rng);
+
+	/**
+	 * @brief Seeds the threads' generators again from the given one, so a pool kept between searches still draws from each search's seed
+	 * @param rng random number generator used to seed one per thread
+	 */
+	void reseed(Random& rng);
+
+	/**
+	 * @brief Returns the number of playouts run for each game state, counting the calling thread's
+	 * @return number of threads
+	 */
+	[[nodiscard]] unsigned int getThreads() const;
+private:
+	/**
+	 * @brief Waits for game states and plays them out until the pool is stopped
+	 * @param workerRng random number generator of the thread
+	 */
+	void work(Random& workerRng);
+
+	/**
+	 * @brief Function used to play out game states
+	 */
+	Playout playoutFunction;
+	/**
+	 * @brief Random number generator of each thread
+	 */
+	std::vector<Random> workerRngs;
+	/**
+	 * @brief Threads of the pool
+	 */
+	std::vector<std::thread> workers;
+	/**
+	 * @brief Held while reading or changing the state shared with the threads
+	 */
+	std::mutex mutex;
+	/**
+	 * @brief Notified when there is a new game state to play out or the pool is stopped
+	 */
+	std::condition_variable started;
+	/**
+	 * @brief Notified when every thread is done with the current game state
+	 */
+	std::condition_variable finished;
+	/**
+	 * @brief Game state currently being played out
+	 */
+	const GameState<SIDE_LENGTH>* gameState = nullptr;
+	/**
+	 * @brief Number of game states handed to the threads so far, used to tell a new game state apart from the last one
+	 */
+	unsigned int generation = 0;
+	/**
+	 * @brief Number of threads still playing out the current game state
+	 */
+	unsigned int remaining = 0;
+	/**
+	 * @brief Total end state value of the threads done with the current game state
+	 */
+	float totalValue = 0;
+	/**
+	 * @brief Whether the threads should stop
+	 */
+	bool stopping = false;
+};
+
+#endif
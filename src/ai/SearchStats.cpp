@@ -0,0 +1,56 @@
+#include <algorithm>
+
+#include "SearchStats.h"
+
+double SearchStats::getSimulationsPerSecond() const {
+	if (seconds <= 0) {
+		return 0;
+	}
+
+	return simulations / seconds;
+}
+
+double SearchStats::getAverageDepth() const {
+	if (simulations == 0) {
+		return 0;
+	}
+
+	return static_cast<double>(totalDepth) / simulations;
+}
+
+SearchStats& SearchStats::operator+=(const SearchStats& other) {
+	simulations += other.simulations;
+	simulationsReused += other.simulationsReused;
+	simulationsSaved += other.simulationsSaved;
+	seconds += other.seconds;
+	selectionSeconds += other.selectionSeconds;
+	evaluationSeconds += other.evaluationSeconds;
+	treeNodes = std::max(treeNodes, other.treeNodes);
+	prunedNodes += other.prunedNodes;
+	maxDepth = std::max(maxDepth, other.maxDepth);
+	totalDepth += other.totalDepth;
+	transpositionLookups += other.transpositionLookups;
+	transpositionHits += other.transpositionHits;
+	cacheLookups += other.cacheLookups;
+	cacheHits += other.cacheHits;
+
+	return *this;
+}
+
+std::ostream& operator<<(std::ostream& out, const SearchStats& stats) {
+	out << stats.simulations << " simulations in " << stats.seconds << " s (" << stats.getSimulationsPerSecond() << " per second), "
+		<< stats.simulationsReused << " reused, " << stats.simulationsSaved << " saved, "
+		<< stats.treeNodes << " nodes, depth " << stats.maxDepth << " max " << stats.getAverageDepth() << " average, "
+		<< stats.selectionSeconds << " s selecting, " << stats.evaluationSeconds << " s evaluating";
+	if (stats.prunedNodes > 0) {
+		out << ", " << stats.prunedNodes << " nodes pruned";
+	}
+	if (stats.transpositionLookups > 0) {
+		out << ", " << stats.transpositionHits << " of " << stats.transpositionLookups << " leaves transposed";
+	}
+	if (stats.cacheLookups > 0) {
+		out << ", " << stats.cacheHits << " of " << stats.cacheLookups << " evaluations cached";
+	}
+
+	return out;
+}
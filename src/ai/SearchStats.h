@@ -0,0 +1,98 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <cstddef>
+#include <ostream>
+
+/**
+ * @brief What a search did, filled in by every MCTS as it searches
+ *
+ * Selection and evaluation times are summed over every search thread, so with several threads they can add up to more than the search took.
+ */
+struct SearchStats {
+	/**
+	 * @brief Number of simulations run
+	 */
+	unsigned int simulations = 0;
+	/**
+	 * @brief Number of simulations kept from the search before that counted towards this one
+	 */
+	unsigned int simulationsReused = 0;
+	/**
+	 * @brief Number of simulations skipped because the best move was already decided
+	 */
+	unsigned int simulationsSaved = 0;
+	/**
+	 * @brief Time the search took in seconds
+	 */
+	double seconds = 0;
+	/**
+	 * @brief Time spent following selection down the tree in seconds
+	 */
+	double selectionSeconds = 0;
+	/**
+	 * @brief Time spent evaluating leaves, by playouts or by the neural network, in seconds
+	 */
+	double evaluationSeconds = 0;
+	/**
+	 * @brief Number of nodes in the tree once the search finished, counting every tree for root parallel searches
+	 */
+	size_t treeNodes = 0;
+	/**
+	 * @brief Number of nodes freed to keep the tree within its node limit
+	 */
+	size_t prunedNodes = 0;
+	/**
+	 * @brief Most moves from the root to a leaf
+	 */
+	unsigned int maxDepth = 0;
+	/**
+	 * @brief Sum of the moves from the root to each leaf, which divided by the simulations gives the average depth
+	 */
+	unsigned long long totalDepth = 0;
+	/**
+	 * @brief Number of new leaves looked up in the transposition table
+	 */
+	unsigned long long transpositionLookups = 0;
+	/**
+	 * @brief Number of new leaves found in the transposition table
+	 */
+	unsigned long long transpositionHits = 0;
+	/**
+	 * @brief Number of neural network evaluations looked up in the evaluation cache
+	 */
+	unsigned long long cacheLookups = 0;
+	/**
+	 * @brief Number of neural network evaluations found in the evaluation cache
+	 */
+	unsigned long long cacheHits = 0;
+
+	/**
+	 * @brief Returns the number of simulations run each second
+	 * @return simulations per second or 0 if the search took no time
+	 */
+	[[nodiscard]] double getSimulationsPerSecond() const;
+
+	/**
+	 * @brief Returns the average number of moves from the root to a leaf
+	 * @return average depth or 0 if no simulations were run
+	 */
+	[[nodiscard]] double getAverageDepth() const;
+
+	/**
+	 * @brief Adds the statistics of another search, such as the next turn of the same game, keeping the larger tree size and depth
+	 * @param other statistics to add
+	 * @return these statistics
+	 */
+	SearchStats& operator+=(const SearchStats& other);
+};
+
+/**
+ * @brief Writes search statistics on one line
+ * @param out stream to write to
+ * @param stats statistics to write
+ * @return the stream
+ */
+std::ostream& operator<<(std::ostream& out, const SearchStats& stats);
+
+#endif
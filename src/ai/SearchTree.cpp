@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <new>
+
+#include "MCTSConstants.h"
+
+#include "SearchTree.h"
+
+template <unsigned int SIDE_LENGTH>
+typename SearchTree<SIDE_LENGTH>::Node* SearchTree<SIDE_LENGTH>::getRoot(GameState<SIDE_LENGTH>* gameState) {
+	if (root != nullptr && root->gameState == gameState) {
+		return root;
+	}
+
+	clear();
+	root = newNode(gameState);
+
+	return root;
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::expand(Node* node, const std::vector<float>& probabilities) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (node->expanded.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	const auto childCount = static_cast<unsigned int>(node->gameState->getValidMoves()->size());
+
+	//Stores the statistic arrays followed by the child pointers in one block
+	const size_t statisticsSize = getStatisticsSize(childCount);
+	char* block = static_cast<char*>(resource.allocate(statisticsSize + childCount * sizeof(std::atomic<Node*>), alignof(std::atomic<Node*>)));
+
+	const size_t countersSize = childCount * sizeof(std::atomic<unsigned int>);
+	const size_t totalsSize = childCount * sizeof(std::atomic<float>);
+	node->childCount = childCount;
+	node->visits = reinterpret_cast<std::atomic<unsigned int>*>(block);
+	node->virtualLosses = reinterpret_cast<std::atomic<unsigned int>*>(block + countersSize);
+	node->amafVisits = reinterpret_cast<std::atomic<unsigned int>*>(block + 2 * countersSize);
+	node->totalValues = reinterpret_cast<std::atomic<float>*>(block + 3 * countersSize);
+	node->amafTotalValues = reinterpret_cast<std::atomic<float>*>(block + 3 * countersSize + totalsSize);
+	node->priors = reinterpret_cast<float*>(block + 3 * countersSize + 2 * totalsSize);
+	node->children = reinterpret_cast<std::atomic<Node*>*>(block + statisticsSize);
+	for (unsigned int i = 0; i < childCount; i++) {
+		new(&node->visits[i]) std::atomic<unsigned int>(0);
+		new(&node->virtualLosses[i]) std::atomic<unsigned int>(0);
+		new(&node->amafVisits[i]) std::atomic<unsigned int>(0);
+		new(&node->totalValues[i]) std::atomic<float>(0.0f);
+		new(&node->amafTotalValues[i]) std::atomic<float>(0.0f);
+		node->priors[i] = probabilities.empty() ? 0.0f : probabilities.at(i);
+		new(&node->children[i]) std::atomic<Node*>(nullptr);
+	}
+
+	node->expanded.store(true, std::memory_order_release);
+}
+
+template <unsigned int SIDE_LENGTH>
+typename SearchTree<SIDE_LENGTH>::Node* SearchTree<SIDE_LENGTH>::getChild(Node* node, const unsigned int index) {
+	Node* child = node->children[index].load(std::memory_order_acquire);
+	if (child != nullptr) {
+		return child;
+	}
+
+	//Checks again in case another thread created the child while waiting for the lock
+	std::lock_guard<std::mutex> lock(mutex);
+	child = node->children[index].load(std::memory_order_relaxed);
+	if (child == nullptr) {
+		child = newNode(node->gameState->getChild(index));
+		node->children[index].store(child, std::memory_order_release);
+	}
+
+	return child;
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int SearchTree<SIDE_LENGTH>::getVisits(const std::vector<PathStep>& path) const {
+	if (path.empty()) {
+		return rootVisits;
+	}
+
+	return path.back().node->visits[path.back().index];
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::backup(const std::vector<PathStep>& path, const float value) {
+	for (auto step = path.rbegin(); step != path.rend(); ++step) {
+		//Counts the visit before removing the virtual loss so the child never looks less visited than it is
+		step->node->visits[step->index]++;
+		addValue(step->node->totalValues[step->index], value);
+		step->node->virtualLosses[step->index] -= VIRTUAL_LOSS;
+	}
+
+	rootVisits++;
+	addValue(rootTotalValue, value);
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::backupAmaf(const std::vector<PathStep>& path, const float value, Bitboard<SIDE_LENGTH> blackCells, Bitboard<SIDE_LENGTH> whiteCells) {
+	//Walks from the end of the path back to the root, adding each move as it goes, so every node only counts moves played after it
+	for (auto step = path.rbegin(); step != path.rend(); ++step) {
+		Node* node = step->node;
+		Bitboard<SIDE_LENGTH>& cells = node->gameState->getColor() == 'O' ? whiteCells : blackCells;
+		const std::pmr::vector<int>& validMoves = *node->gameState->getValidMoves();
+		if (validMoves[step->index] >= 0) {
+			cells.set(validMoves[step->index]);
+		}
+
+		//Passing is left out since it does not say anything about the rest of the game
+		for (unsigned int i = 0; i < node->childCount; i++) {
+			if (validMoves[i] >= 0 && cells.test(validMoves[i])) {
+				node->amafVisits[i]++;
+				addValue(node->amafTotalValues[i], value);
+			}
+		}
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+bool SearchTree<SIDE_LENGTH>::isForced() const {
+	return root != nullptr && root->isExpanded() && root->childCount == 1 && root->visits[0] > 0;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool SearchTree<SIDE_LENGTH>::isDecided(const unsigned int remaining) const {
+	if (root == nullptr || !root->isExpanded()) {
+		return false;
+	}
+	if (isForced()) {
+		return true;
+	}
+
+	unsigned int mostVisits = 0;
+	unsigned int secondMostVisits = 0;
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		const unsigned int visits = root->visits[i];
+		if (visits > mostVisits) {
+			secondMostVisits = mostVisits;
+			mostVisits = visits;
+		} else if (visits > secondMostVisits) {
+			secondMostVisits = visits;
+		}
+	}
+
+	//Ties could go to the runner up, so it has to be unable to even catch up
+	return mostVisits - secondMostVisits > remaining;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool SearchTree<SIDE_LENGTH>::isValueDecided(const unsigned int remaining) const {
+	if (root == nullptr || !root->isExpanded()) {
+		return false;
+	}
+	if (isForced() || remaining == 0) {
+		return true;
+	}
+
+	//Values are from white's side, so black's are flipped to make higher better, with unvisited children counting as 0 like in BasicMCTS::getBestMove
+	const float sign = root->gameState->getColor() == 'X' ? -1.0f : 1.0f;
+	unsigned int best = 0;
+	float bestAverage = -2.0f;
+	float bestVisits = 0.0f;
+	float bestTotal = 0.0f;
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		const auto visits = static_cast<float>(root->visits[i].load());
+		const float total = sign * root->totalValues[i].load();
+		const float average = visits > 0 ? total / visits : 0.0f;
+		if (average > bestAverage) {
+			bestAverage = average;
+			best = i;
+			bestVisits = visits;
+			bestTotal = total;
+		}
+	}
+
+	//Each simulation is worth between -1 and 1, and ties go to the first child, so the best child has to stay strictly ahead
+	const auto left = static_cast<float>(remaining);
+	const float lowest = (bestTotal - left) / (bestVisits + left);
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		if (i != best && (sign * root->totalValues[i].load() + left) / (static_cast<float>(root->visits[i].load()) + left) >= lowest) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool SearchTree<SIDE_LENGTH>::getStatistics(const GameState<SIDE_LENGTH>* gameState, float& visits, float& totalValue) const {
+	if (root == nullptr) {
+		return false;
+	}
+
+	if (root->gameState == gameState) {
+		visits = static_cast<float>(rootVisits);
+		totalValue = rootTotalValue;
+		return rootVisits > 0;
+	}
+
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		const Node* child = root->children[i];
+		if (child != nullptr && child->gameState == gameState) {
+			visits = static_cast<float>(root->visits[i]);
+			totalValue = root->totalValues[i];
+			return root->visits[i] > 0;
+		}
+	}
+
+	return false;
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::merge(const SearchTree& other) {
+	if (root == nullptr || other.root == nullptr) {
+		return;
+	}
+
+	rootVisits += other.rootVisits;
+	addValue(rootTotalValue, other.rootTotalValue);
+	if (!other.root->isExpanded()) {
+		return;
+	}
+
+	//Both roots list the same valid moves in the same order since they hold the same position
+	expand(root);
+	for (unsigned int i = 0; i < root->childCount; i++) {
+		root->visits[i] += other.root->visits[i];
+		addValue(root->totalValues[i], other.root->totalValues[i]);
+		root->amafVisits[i] += other.root->amafVisits[i];
+		addValue(root->amafTotalValues[i], other.root->amafTotalValues[i]);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::advance(const unsigned int index) {
+	if (root == nullptr || index >= root->childCount || root->children[index] == nullptr) {
+		clear();
+		return;
+	}
+
+	Node* child = root->children[index];
+	rootVisits = root->visits[index].load();
+	rootTotalValue = root->totalValues[index].load();
+	reusedVisits = rootVisits;
+
+	root->children[index] = nullptr;
+	release(root);
+	root = child;
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::clear() {
+	//Nodes only hold pointers and atomics, so their memory is released without destroying them one at a time
+	root = nullptr;
+	rootVisits = 0;
+	rootTotalValue = 0.0f;
+	reusedVisits = 0;
+	nodeCount = 0;
+	resource.release();
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t SearchTree<SIDE_LENGTH>::prune(const size_t nodeLimit) {
+	if (root == nullptr || nodeCount <= nodeLimit) {
+		return 0;
+	}
+	const size_t startCount = nodeCount;
+
+	/**
+	 * @brief Child that can be freed along with its subtree
+	 */
+	struct Edge {
+		Node* parent;
+		unsigned int index;
+		unsigned int visits;
+		unsigned int depth;
+	};
+
+	//Lists every child below the root's children, which are kept since moves are picked from them
+	std::vector<Edge> edges;
+	std::vector<std::pair<Node*, unsigned int>> stack = {{root, 0}};
+	while (!stack.empty()) {
+		const auto [node, depth] = stack.back();
+		stack.pop_back();
+		if (!node->isExpanded()) {
+			continue;
+		}
+
+		for (unsigned int i = 0; i < node->childCount; i++) {
+			Node* child = node->children[i];
+			if (child == nullptr) {
+				continue;
+			}
+			if (depth > 0) {
+				edges.push_back({node, i, node->visits[i].load(), depth});
+			}
+			stack.emplace_back(child, depth + 1);
+		}
+	}
+
+	//A child never has more visits than its parent, so freeing the least visited first, and the deepest first among ties, never frees a subtree after one holding it
+	std::sort(edges.begin(), edges.end(), [](const Edge& first, const Edge& second) {
+		return first.visits != second.visits ? first.visits < second.visits : first.depth > second.depth;
+	});
+	for (const Edge& edge : edges) {
+		if (nodeCount <= nodeLimit) {
+			break;
+		}
+
+		Node* child = edge.parent->children[edge.index];
+		edge.parent->children[edge.index] = nullptr;
+		release(child);
+		delete edge.parent->gameState->getChild(edge.index, false);
+	}
+
+	return startCount - nodeCount;
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t SearchTree<SIDE_LENGTH>::getNodeCount() const {
+	return nodeCount;
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::addValue(std::atomic<float>& total, const float value) {
+	float expected = total.load(std::memory_order_relaxed);
+	while (!total.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed)) {
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t SearchTree<SIDE_LENGTH>::getStatisticsSize(const unsigned int childCount) {
+	const size_t size = childCount * (3 * sizeof(std::atomic<unsigned int>) + 2 * sizeof(std::atomic<float>) + sizeof(float));
+	return (size + alignof(std::atomic<Node*>) - 1) / alignof(std::atomic<Node*>) * alignof(std::atomic<Node*>);
+}
+
+template <unsigned int SIDE_LENGTH>
+typename SearchTree<SIDE_LENGTH>::Node* SearchTree<SIDE_LENGTH>::newNode(GameState<SIDE_LENGTH>* gameState) {
+	nodeCount++;
+	return new(resource.allocate(sizeof(Node), alignof(Node))) Node(gameState);
+}
+
+template <unsigned int SIDE_LENGTH>
+void SearchTree<SIDE_LENGTH>::release(Node* node) {
+	//Uses an explicit stack since subtrees can be as deep as a game is long
+	std::vector<Node*> stack = {node};
+	while (!stack.empty()) {
+		Node* current = stack.back();
+		stack.pop_back();
+
+		if (current->isExpanded()) {
+			for (unsigned int i = 0; i < current->childCount; i++) {
+				Node* child = current->children[i];
+				if (child != nullptr) {
+					stack.emplace_back(child);
+				}
+			}
+			resource.deallocate(current->visits, getStatisticsSize(current->childCount) + current->childCount * sizeof(std::atomic<Node*>), alignof(std::atomic<Node*>));
+		}
+		resource.deallocate(current, sizeof(Node), alignof(Node));
+		nodeCount--;
+	}
+}
+
+template class SearchTree<5>;
+template class SearchTree<7>;
+template class SearchTree<9>;
+template class SearchTree<13>;
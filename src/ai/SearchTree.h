@@ -0,0 +1,266 @@
+#ifndef SEARCH_TREE_H
+#define SEARCH_TREE_H
+
+#include <atomic>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+#include "../game/GameState.h"
+
+/**
+ * @brief Search statistics for MCTS stored per node, with the statistics of a node's children kept side by side in arrays
+ *
+ * Statistics are atomic so several threads can search the tree at once. Creating nodes changes the game state tree and allocates memory, so it is done under a lock, while reading and updating statistics is not.
+ */
+template <unsigned int SIDE_LENGTH>
+class SearchTree {
+public:
+	struct Node {
+		/**
+		 * @brief Constructs an unexpanded node
+		 * @param gameState game state the node refers to
+		 */
+		explicit Node(GameState<SIDE_LENGTH>* gameState) : gameState(gameState) {
+		}
+
+		/**
+		 * @brief Game state the node refers to, which is owned by the game state tree
+		 */
+		GameState<SIDE_LENGTH>* gameState;
+		/**
+		 * @brief Whether the arrays for the children have been allocated, set once they are ready to be read
+		 */
+		std::atomic<bool> expanded = false;
+		/**
+		 * @brief Number of children, which matches the game state's valid moves once expanded
+		 */
+		unsigned int childCount = 0;
+		/**
+		 * @brief Number of times each child was visited
+		 */
+		std::atomic<unsigned int>* visits = nullptr;
+		/**
+		 * @brief Number of threads currently simulating past each child
+		 */
+		std::atomic<unsigned int>* virtualLosses = nullptr;
+		/**
+		 * @brief Total value from all of the simulations that went past each child
+		 */
+		std::atomic<float>* totalValues = nullptr;
+		/**
+		 * @brief Number of simulations that went past the node and played each child's move later on for the same player, unused by AdvancedMCTS
+		 */
+		std::atomic<unsigned int>* amafVisits = nullptr;
+		/**
+		 * @brief Total value from all of the simulations counted in amafVisits
+		 */
+		std::atomic<float>* amafTotalValues = nullptr;
+		/**
+		 * @brief Probability of each child given by a neural network, unused by BasicMCTS
+		 */
+		float* priors = nullptr;
+		/**
+		 * @brief Node of each child or null if the child was never selected
+		 */
+		std::atomic<Node*>* children = nullptr;
+
+		/**
+		 * @brief Returns whether the arrays for the children have been allocated
+		 * @return whether the node is expanded
+		 */
+		[[nodiscard]] bool isExpanded() const {
+			return expanded.load(std::memory_order_acquire);
+		}
+	};
+
+	/**
+	 * @brief Node passed through during selection along with the index of the child selected
+	 */
+	struct PathStep {
+		/**
+		 * @brief Node passed through
+		 */
+		Node* node;
+		/**
+		 * @brief Index of the child selected in the node's valid moves
+		 */
+		unsigned int index;
+	};
+
+	/**
+	 * @brief Constructs an empty tree
+	 */
+	SearchTree() = default;
+
+	//Prevents copying/moving trees since nodes point into the tree's memory
+	SearchTree(const SearchTree& other) = delete;
+	SearchTree& operator=(const SearchTree& other) = delete;
+	SearchTree(const SearchTree&& other) = delete;
+	SearchTree& operator=(const SearchTree&& other) = delete;
+
+	/**
+	 * @brief Returns the root node for the given game state, clearing the tree if it was rooted somewhere else
+	 * @param gameState game state to search from
+	 * @return root node
+	 */
+	Node* getRoot(GameState<SIDE_LENGTH>* gameState);
+
+	/**
+	 * @brief Allocates the arrays for a node's children with every statistic set to 0, unless another thread already did
+	 * @param node node to expand
+	 * @param probabilities probabilities of making each valid move to use as priors, or empty to leave the priors at 0
+	 */
+	void expand(Node* node, const std::vector<float>& probabilities = {});
+
+	/**
+	 * @brief Returns the node of a child, creating it and its game state if needed
+	 * @param node expanded node to get the child of
+	 * @param index index of the child in valid moves
+	 * @return node of the child
+	 */
+	Node* getChild(Node* node, unsigned int index);
+
+	/**
+	 * @brief Returns the number of times the node at the end of a path was visited
+	 * @param path steps taken from the root
+	 * @return number of visits
+	 */
+	[[nodiscard]] unsigned int getVisits(const std::vector<PathStep>& path) const;
+
+	/**
+	 * @brief Adds a simulation result to every node on a path from its end back to the root, removing the virtual losses added while selecting it
+	 * @param path steps taken from the root
+	 * @param value final value of simulation
+	 */
+	void backup(const std::vector<PathStep>& path, float value);
+
+	/**
+	 * @brief Adds a simulation result to the all moves as first statistics of every child whose move the player at its node went on to play, whether on the path or after it
+	 * @param path steps taken from the root
+	 * @param value final value of simulation
+	 * @param blackCells cells black placed a piece on after the end of the path
+	 * @param whiteCells cells white placed a piece on after the end of the path
+	 */
+	void backupAmaf(const std::vector<PathStep>& path, float value, Bitboard<SIDE_LENGTH> blackCells, Bitboard<SIDE_LENGTH> whiteCells);
+
+	/**
+	 * @brief Returns whether the root has only one child and it was visited, so there is nothing left to decide
+	 * @return whether the root's move is forced
+	 */
+	[[nodiscard]] bool isForced() const;
+
+	/**
+	 * @brief Returns whether the root's most visited child is certain to stay the most visited, which is when the move is forced or when it leads every other child by more visits than are left to run
+	 * @param remaining number of simulations left in the search
+	 * @return whether the most visited child cannot be overtaken
+	 */
+	[[nodiscard]] bool isDecided(unsigned int remaining) const;
+
+	/**
+	 * @brief Returns whether the root's child with the best average value for the player to move is certain to stay the best, which is when the move is forced or when no other child could pass it even if every simulation left lost for it and won for the other child
+	 * @param remaining number of simulations left in the search
+	 * @return whether the best average cannot be overtaken
+	 */
+	[[nodiscard]] bool isValueDecided(unsigned int remaining) const;
+
+	/**
+	 * @brief Finds the statistics of the root or one of its children
+	 * @param gameState game state to look for
+	 * @param visits set to the number of visits if found
+	 * @param totalValue set to the total value if found
+	 * @return whether the game state was found and visited
+	 */
+	bool getStatistics(const GameState<SIDE_LENGTH>* gameState, float& visits, float& totalValue) const;
+
+	/**
+	 * @brief Adds the root statistics of another tree searched from a copy of the same position to this tree's root, expanding the root if needed
+	 * @param other tree to take the statistics from, which must not be searched during the merge
+	 */
+	void merge(const SearchTree& other);
+
+	/**
+	 * @brief Makes a child of the root the new root, keeping its subtree and freeing the rest of the tree
+	 * @param index index of the child in the root's valid moves
+	 */
+	void advance(unsigned int index);
+
+	/**
+	 * @brief Removes every node
+	 */
+	void clear();
+
+	/**
+	 * @brief Frees the least visited subtrees below the root's children, along with their game states, until the tree has at most the given number of nodes, which must be done while no thread is searching the tree
+	 *
+	 * A freed subtree's statistics stay in its parent, so searching the move again rebuilds the subtree from there. The freed game states are deleted from the game tree, which the search has to own.
+	 * @param nodeLimit number of nodes to get down to
+	 * @return number of nodes freed
+	 */
+	size_t prune(size_t nodeLimit);
+
+	/**
+	 * @brief Returns the number of nodes in the tree
+	 * @return number of nodes
+	 */
+	[[nodiscard]] size_t getNodeCount() const;
+
+	/**
+	 * @brief Adds to an atomic total without a lock
+	 * @param total total to add to
+	 * @param value value to add
+	 */
+	static void addValue(std::atomic<float>& total, float value);
+
+	/**
+	 * @brief Number of times the root was visited
+	 */
+	std::atomic<unsigned int> rootVisits = 0;
+	/**
+	 * @brief Total value from all of the simulations that went past the root
+	 */
+	std::atomic<float> rootTotalValue = 0.0f;
+	/**
+	 * @brief Number of simulations kept for the root by the last advance that have not been counted towards a search yet
+	 */
+	unsigned int reusedVisits = 0;
+private:
+	/**
+	 * @brief Returns the size of the statistic arrays in a node's block, which the child pointers follow
+	 * @param childCount number of children
+	 * @return size of the statistic arrays
+	 */
+	static size_t getStatisticsSize(unsigned int childCount);
+
+	/**
+	 * @brief Returns a new node allocated from the tree's memory, which must be done while holding the lock
+	 * @param gameState game state the node refers to
+	 * @return new node
+	 */
+	Node* newNode(GameState<SIDE_LENGTH>* gameState);
+
+	/**
+	 * @brief Frees a node along with its subtree
+	 * @param node node to free
+	 */
+	void release(Node* node);
+
+	/**
+	 * @brief Memory resource nodes and their arrays are allocated from
+	 */
+	std::pmr::unsynchronized_pool_resource resource;
+	/**
+	 * @brief Held while creating nodes
+	 */
+	std::mutex mutex;
+	/**
+	 * @brief Root node or null if the tree is empty
+	 */
+	Node* root = nullptr;
+	/**
+	 * @brief Number of nodes in the tree, which is read by search threads checking whether the tree is full
+	 */
+	std::atomic<size_t> nodeCount = 0;
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include <algorithm>
+
+#include "../game/GameStateConstants.h"
+#include "../game/Symmetry.h"
+#include "../game/Zobrist.h"
+
+#include "TranspositionTable.h"
+
+/**
+ * @brief Key XORed into the keys of positions where white is to move
+ */
+constexpr uint64_t WHITE_TO_MOVE_KEY = 0x8F2A61C53B9E07D1;
+/**
+ * @brief Key XORed into the keys of positions where the last move was a pass
+ */
+constexpr uint64_t PASSED_KEY = 0x3C79AD4E1F50B862;
+/**
+ * @brief Seed for the keys XORed into the keys of positions with a ko point, offset by the cell of the ko point
+ */
+constexpr uint64_t KO_KEY = 0xD61E4B0A97C3F258;
+
+template <unsigned int SIDE_LENGTH>
+TranspositionTable<SIDE_LENGTH>::TranspositionTable(const unsigned int capacity, const bool storeEvaluations) {
+	size_t bucketCount = 1;
+	while (bucketCount * BUCKET_SIZE < capacity) {
+		bucketCount *= 2;
+	}
+
+	entries.resize(bucketCount * BUCKET_SIZE);
+	if (storeEvaluations) {
+		priors.resize(entries.size() * NUM_MOVES<SIDE_LENGTH>);
+	}
+	bucketMask = bucketCount - 1;
+}
+
+template <unsigned int SIDE_LENGTH>
+uint64_t TranspositionTable<SIDE_LENGTH>::getKey(const GameState<SIDE_LENGTH>* gameState) {
+	unsigned int symmetry;
+	return getKey(gameState, symmetry);
+}
+
+template <unsigned int SIDE_LENGTH>
+uint64_t TranspositionTable<SIDE_LENGTH>::getKey(const GameState<SIDE_LENGTH>* gameState, unsigned int& symmetry) {
+	uint64_t sharedKey = 0;
+	if (gameState->getColor() == 'O') {
+		sharedKey ^= WHITE_TO_MOVE_KEY;
+	}
+	if (gameState->getPassed()) {
+		sharedKey ^= PASSED_KEY;
+	}
+
+	//A single stone captured by the last move marks a ko point where retaking may be banned
+	unsigned int koPoint = AREA<SIDE_LENGTH>;
+	if (gameState->getHistory() != nullptr) {
+		const char color = gameState->getColor();
+		const Bitboard<SIDE_LENGTH> captured = gameState->getHistory()->getPosition().pieces(color) & ~gameState->getPosition()->pieces(color);
+		if (captured.count() == 1) {
+			koPoint = captured.lowest();
+		}
+	}
+
+	const uint64_t key = getCanonicalKey([gameState, sharedKey, koPoint](const unsigned int candidate) {
+		uint64_t candidateKey = hashPosition(*gameState->getPosition(), candidate) ^ sharedKey;
+		if (koPoint < AREA<SIDE_LENGTH>) {
+			uint64_t state = KO_KEY + SYMMETRY_CELLS<SIDE_LENGTH>[candidate][koPoint];
+			candidateKey ^= splitMix64(state);
+		}
+		return candidateKey;
+	}, symmetry);
+
+	//0 marks empty entries
+	return key == 0 ? 1 : key;
+}
+
+template <unsigned int SIDE_LENGTH>
+void TranspositionTable<SIDE_LENGTH>::newSearch() {
+	generation++;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool TranspositionTable<SIDE_LENGTH>::getStatistics(const uint64_t key, float& visits, float& totalValue) {
+	std::lock_guard<std::mutex> lock(getLock(key));
+	const size_t index = find(key);
+	if (index == entries.size() || entries[index].visits == 0) {
+		return false;
+	}
+
+	visits = static_cast<float>(entries[index].visits);
+	totalValue = entries[index].totalValue;
+	return true;
+}
+
+template <unsigned int SIDE_LENGTH>
+void TranspositionTable<SIDE_LENGTH>::update(const uint64_t key, const float value) {
+	std::lock_guard<std::mutex> lock(getLock(key));
+	Entry& entry = entries[insert(key)];
+	entry.visits++;
+	entry.totalValue += value;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool TranspositionTable<SIDE_LENGTH>::getEvaluation(const uint64_t key, const unsigned int symmetry, std::vector<float>& probabilities, float& value) {
+	if (priors.empty()) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(getLock(key));
+	const size_t index = find(key);
+	if (index == entries.size() || !entries[index].evaluated) {
+		return false;
+	}
+
+	probabilities.resize(NUM_MOVES<SIDE_LENGTH>);
+	undoSymmetry<SIDE_LENGTH>(priors.data() + index * NUM_MOVES<SIDE_LENGTH>, symmetry, probabilities.data());
+	value = entries[index].value;
+	return true;
+}
+
+template <unsigned int SIDE_LENGTH>
+void TranspositionTable<SIDE_LENGTH>::storeEvaluation(const uint64_t key, const unsigned int symmetry, const std::vector<float>& probabilities, const float value) {
+	if (priors.empty()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(getLock(key));
+	const size_t index = insert(key);
+	applySymmetry<SIDE_LENGTH>(probabilities.data(), symmetry, priors.data() + index * NUM_MOVES<SIDE_LENGTH>);
+	entries[index].value = value;
+	entries[index].evaluated = true;
+}
+
+template <unsigned int SIDE_LENGTH>
+void TranspositionTable<SIDE_LENGTH>::clear() {
+	std::fill(entries.begin(), entries.end(), Entry());
+	generation = 1;
+}
+
+template <unsigned int SIDE_LENGTH>
+std::mutex& TranspositionTable<SIDE_LENGTH>::getLock(const uint64_t key) {
+	return locks[(key & bucketMask) % LOCK_COUNT];
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t TranspositionTable<SIDE_LENGTH>::find(const uint64_t key) const {
+	const size_t bucket = (key & bucketMask) * BUCKET_SIZE;
+	for (size_t i = bucket; i < bucket + BUCKET_SIZE; i++) {
+		if (entries[i].key == key) {
+			return i;
+		}
+	}
+
+	return entries.size();
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t TranspositionTable<SIDE_LENGTH>::insert(const uint64_t key) {
+	const size_t index = find(key);
+	if (index != entries.size()) {
+		entries[index].generation = generation;
+		return index;
+	}
+
+	const size_t bucket = (key & bucketMask) * BUCKET_SIZE;
+	size_t replacement = bucket;
+	for (size_t i = bucket; i < bucket + BUCKET_SIZE; i++) {
+		Entry& entry = entries[i];
+		if (entry.key == 0) {
+			entry.key = key;
+			entry.generation = generation;
+			return i;
+		}
+
+		//Prefers replacing entries from older searches, then entries with fewer visits
+		const Entry& candidate = entries[replacement];
+		if (entry.generation < candidate.generation || (entry.generation == candidate.generation && entry.visits < candidate.visits)) {
+			replacement = i;
+		}
+	}
+
+	entries[replacement] = Entry();
+	entries[replacement].key = key;
+	entries[replacement].generation = generation;
+	return replacement;
+}
+
+template class TranspositionTable<5>;
+template class TranspositionTable<7>;
+template class TranspositionTable<9>;
+template class TranspositionTable<13>;
@@ -0,0 +1,171 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../game/GameState.h"
+
+/**
+ * @brief Bounded table of search statistics and neural network evaluations keyed by position, shared by every node that reaches the same position through a different move order
+ *
+ * Entries are grouped into buckets of BUCKET_SIZE. When a bucket is full, the entry last used by the oldest search is replaced, with ties going to the entry with the fewest visits. Entries are guarded by a fixed set of locks so several search threads can use the table at once.
+ */
+template <unsigned int SIDE_LENGTH>
+class TranspositionTable {
+public:
+	/**
+	 * @brief Number of entries a key can be stored in
+	 */
+	static constexpr unsigned int BUCKET_SIZE = 4;
+
+	/**
+	 * @brief Constructs an empty table with room for at least the given number of entries, rounded up to a power of two
+	 * @param capacity minimum number of entries
+	 * @param storeEvaluations whether to keep room for neural network move probabilities in every entry
+	 */
+	TranspositionTable(unsigned int capacity, bool storeEvaluations);
+
+	/**
+	 * @brief Returns the key of a game state, which covers the board, the player to move, whether the last move was a pass, and the ko point left by a single stone capture
+	 *
+	 * The rest of the history is left out so that transpositions share an entry, which means positions that only differ in which long cycles superko bans share statistics. The board and ko point are first moved by whichever rotation or reflection gives the smallest key, so all eight symmetric variants of a position share one entry too.
+	 * @param gameState game state to get the key of
+	 * @return key of the game state
+	 */
+	static uint64_t getKey(const GameState<SIDE_LENGTH>* gameState);
+
+	/**
+	 * @brief Returns the key of a game state like getKey, along with the symmetry needed to orient stored move probabilities
+	 * @param gameState game state to get the key of
+	 * @param symmetry set to the symmetry the board was moved by
+	 * @return key of the game state
+	 */
+	static uint64_t getKey(const GameState<SIDE_LENGTH>* gameState, unsigned int& symmetry);
+
+	/**
+	 * @brief Marks the start of a search so entries used by older searches are replaced first
+	 */
+	void newSearch();
+
+	/**
+	 * @brief Finds the statistics of a position merged across every node that reached it
+	 * @param key key of the position
+	 * @param visits set to the number of visits if found
+	 * @param totalValue set to the total value if found
+	 * @return whether the position was found and visited
+	 */
+	bool getStatistics(uint64_t key, float& visits, float& totalValue);
+
+	/**
+	 * @brief Adds a simulation result to a position, making an entry for it if needed
+	 * @param key key of the position
+	 * @param value final value of simulation
+	 */
+	void update(uint64_t key, float value);
+
+	/**
+	 * @brief Finds the neural network evaluation of a position
+	 * @param key key of the position
+	 * @param symmetry symmetry given by getKey
+	 * @param probabilities set to the move probabilities given by the neural network in the position's own orientation if found
+	 * @param value set to the value given by the neural network if found
+	 * @return whether the position was found and evaluated
+	 */
+	bool getEvaluation(uint64_t key, unsigned int symmetry, std::vector<float>& probabilities, float& value);
+
+	/**
+	 * @brief Stores the neural network evaluation of a position, making an entry for it if needed, which does nothing unless the table stores evaluations
+	 * @param key key of the position
+	 * @param symmetry symmetry given by getKey
+	 * @param probabilities move probabilities given by the neural network in the position's own orientation
+	 * @param value value given by the neural network
+	 */
+	void storeEvaluation(uint64_t key, unsigned int symmetry, const std::vector<float>& probabilities, float value);
+
+	/**
+	 * @brief Removes every entry
+	 */
+	void clear();
+private:
+	/**
+	 * @brief Statistics and evaluation of one position
+	 */
+	struct Entry {
+		/**
+		 * @brief Key of the position or 0 if the entry is empty
+		 */
+		uint64_t key = 0;
+		/**
+		 * @brief Last search the entry was used by
+		 */
+		unsigned int generation = 0;
+		/**
+		 * @brief Number of times the position was visited
+		 */
+		unsigned int visits = 0;
+		/**
+		 * @brief Total value from all of the simulations that went past the position
+		 */
+		float totalValue = 0;
+		/**
+		 * @brief Value given by the neural network
+		 */
+		float value = 0;
+		/**
+		 * @brief Whether the neural network evaluation is stored
+		 */
+		bool evaluated = false;
+	};
+
+	/**
+	 * @brief Number of locks guarding the buckets
+	 */
+	static constexpr unsigned int LOCK_COUNT = 64;
+
+	/**
+	 * @brief Returns the lock guarding the bucket of a key
+	 * @param key key of the position
+	 * @return lock guarding the bucket
+	 */
+	std::mutex& getLock(uint64_t key);
+
+	/**
+	 * @brief Returns the index of the entry holding a key, which must be done while holding the bucket's lock
+	 * @param key key of the position
+	 * @return index of the entry or entries.size() if the key is not stored
+	 */
+	size_t find(uint64_t key) const;
+
+	/**
+	 * @brief Returns the index of the entry holding a key, replacing an entry in the bucket if the key is not stored, which must be done while holding the bucket's lock
+	 * @param key key of the position
+	 * @return index of the entry
+	 */
+	size_t insert(uint64_t key);
+
+	/**
+	 * @brief Entries grouped into buckets
+	 */
+	std::vector<Entry> entries;
+	/**
+	 * @brief Move probabilities of each entry one after the other, oriented like the board the entry's key was taken from, empty unless the table stores evaluations
+	 */
+	std::vector<float> priors;
+	/**
+	 * @brief Number of buckets minus one, used to find the bucket of a key
+	 */
+	uint64_t bucketMask;
+	/**
+	 * @brief Current search
+	 */
+	unsigned int generation = 1;
+	/**
+	 * @brief Locks guarding the buckets
+	 */
+	std::array<std::mutex, LOCK_COUNT> locks;
+};
+
+#endif
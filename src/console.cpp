@@ -4,35 +4,45 @@
 #include "ai/BasicMCTS.h"
 #include "ai/AdvancedMCTS.h"
 
+/**
+ * @brief Side length of the board played in the console
+ */
+constexpr unsigned int SIDE_LENGTH = 5;
+
 int main(int argc, char* argv[]) {
 	if (argc < 5) {
 		std::cout << "Please give 4 arguments: model1 path or the word basic, mcts1 simulations, model2 path or the word basic, mcts2 simulations" << '\n';
 	}
 
-	MCTS* mcts1;
-	MCTS* mcts2;
-	NeuralNetwork neuralNetwork1, neuralNetwork2;
+	MCTS<SIDE_LENGTH>* mcts1;
+	MCTS<SIDE_LENGTH>* mcts2;
+	NeuralNetwork<SIDE_LENGTH> neuralNetwork1, neuralNetwork2;
 
 	if (strlen(argv[1]) == 5 && strncmp(argv[1], "basic", 5) == 0) {
-		mcts1 = new BasicMCTS(std::stoi(argv[2]));
+		mcts1 = new BasicMCTS<SIDE_LENGTH>(std::stoi(argv[2]));
 	} else {
 		neuralNetwork1.load(argv[1]);
-		mcts1 = new AdvancedMCTS(&neuralNetwork1, std::stoi(argv[2]));
+		mcts1 = new AdvancedMCTS<SIDE_LENGTH>(&neuralNetwork1, std::stoi(argv[2]));
 	}
 
 	if (strlen(argv[3]) == 5 && strncmp(argv[3], "basic", 5) == 0) {
-		mcts2 = new BasicMCTS(std::stoi(argv[4]));
+		mcts2 = new BasicMCTS<SIDE_LENGTH>(std::stoi(argv[4]));
 	} else {
 		neuralNetwork2.load(argv[3]);
-		mcts2 = new AdvancedMCTS(&neuralNetwork2, std::stoi(argv[4]));
+		mcts2 = new AdvancedMCTS<SIDE_LENGTH>(&neuralNetwork2, std::stoi(argv[4]));
 	}
 
-	GameState* gameState = GameState::newGame('X', "#...#.....#.O...........#");
-	gameState->printGameState();
+	//Each search gets its own copy of the game tree, since a search with a node limit deletes game states from the tree it is given
+	GameStatePool<SIDE_LENGTH> pool;
+	GameState<SIDE_LENGTH>* gameState1 = GameState<SIDE_LENGTH>::newGame('X', "#...#.....#.O...........#", {}, &pool);
+	GameState<SIDE_LENGTH>* gameState2 = GameState<SIDE_LENGTH>::newGame('X', "#...#.....#.O...........#", {}, &pool);
+	gameState1->printGameState();
 
-	while (gameState->getEndState() < -1) {
-		std::vector<float> moveProbabilities1 = mcts1->getMoveProbabilities(gameState);
-		std::vector<float> moveProbabilities2 = mcts2->getMoveProbabilities(gameState);
+	while (gameState1->getEndState() < -1) {
+		std::vector<float> moveProbabilities1 = mcts1->getMoveProbabilities(gameState1);
+		std::vector<float> moveProbabilities2 = mcts2->getMoveProbabilities(gameState2);
+		std::cout << "MCTS 1 searched " << mcts1->getStats() << '\n';
+		std::cout << "MCTS 2 searched " << mcts2->getStats() << '\n';
 
 		std::cout << std::left;
 		std::cout << std::setw(3) << "i "
@@ -42,30 +52,35 @@ int main(int argc, char* argv[]) {
 				  << std::setw(12) << "Value 1"
 				  << std::setw(12) << "Value 2" << '\n';
 		
-		for (unsigned int i = 0; i < gameState->getValidMoves()->size(); i++) {
+		for (unsigned int i = 0; i < gameState1->getValidMoves()->size(); i++) {
 			std::cout << std::setw(3) << i
-					  << std::setw(5) << gameState->getValidMoves()->at(i)
-					  << std::setw(12) << moveProbabilities1[gameState->getValidMoves()->at(i) + 1]
-					  << std::setw(12) << moveProbabilities2[gameState->getValidMoves()->at(i) + 1]
-					  << std::setw(12) << mcts1->getMoveValue(gameState->getChild(i))
-					  << std::setw(12) << mcts2->getMoveValue(gameState->getChild(i)) << '\n';
+					  << std::setw(5) << gameState1->getValidMoves()->at(i)
+					  << std::setw(12) << moveProbabilities1[gameState1->getValidMoves()->at(i) + 1]
+					  << std::setw(12) << moveProbabilities2[gameState1->getValidMoves()->at(i) + 1]
+					  << std::setw(12) << mcts1->getMoveValue(gameState1->getChild(i))
+					  << std::setw(12) << mcts2->getMoveValue(gameState2->getChild(i)) << '\n';
 		}
 
 		int moveToPlay;
 		std::cin >> moveToPlay;
 
-		GameState* childGameState = gameState->getChild(moveToPlay, false);
-		delete gameState;
-		gameState = childGameState;
+		//Keeps the chosen child's subtree so the next searches continue from it
+		GameState<SIDE_LENGTH>* childGameState1 = gameState1->getChild(moveToPlay, false);
+		delete gameState1;
+		gameState1 = childGameState1;
+		GameState<SIDE_LENGTH>* childGameState2 = gameState2->getChild(moveToPlay, false);
+		delete gameState2;
+		gameState2 = childGameState2;
+		mcts1->advance(moveToPlay);
+		mcts2->advance(moveToPlay);
 
-		gameState->printGameState();
-		mcts1->reset();
-		mcts2->reset();
+		gameState1->printGameState();
 	}
 
-	std::cout << gameState->getEndState() << '\n';
+	std::cout << gameState1->getEndState() << '\n';
 
-	delete gameState;
+	delete gameState1;
+	delete gameState2;
 	delete mcts1;
 	delete mcts2;
 
@@ -0,0 +1,365 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "GameStateConstants.h"
+
+/**
+ * @brief Set of cells stored as one bit per cell with bit i referring to board index i
+ */
+template <unsigned int SIDE_LENGTH>
+class Bitboard {
+public:
+	/**
+	 * @brief Number of 64 bit words needed to hold one bit per cell
+	 */
+	static constexpr unsigned int WORDS = (AREA<SIDE_LENGTH> + 63) / 64;
+
+	/**
+	 * @brief Constructs an empty bitboard
+	 */
+	constexpr Bitboard() : words{} {
+	}
+
+	/**
+	 * @brief Returns a bitboard with only the given cell set
+	 * @param index cell to set
+	 * @return a bitboard with only the given cell set
+	 */
+	static constexpr Bitboard fromIndex(const unsigned int index) {
+		Bitboard bitboard;
+		bitboard.set(index);
+		return bitboard;
+	}
+
+	/**
+	 * @brief Returns whether the given cell is set
+	 * @param index cell to check
+	 * @return whether the given cell is set
+	 */
+	[[nodiscard]] constexpr bool test(const unsigned int index) const {
+		return (words[index / 64] >> (index % 64)) & 1;
+	}
+
+	/**
+	 * @brief Sets the given cell
+	 * @param index cell to set
+	 */
+	constexpr void set(const unsigned int index) {
+		words[index / 64] |= uint64_t{1} << (index % 64);
+	}
+
+	/**
+	 * @brief Clears the given cell
+	 * @param index cell to clear
+	 */
+	constexpr void reset(const unsigned int index) {
+		words[index / 64] &= ~(uint64_t{1} << (index % 64));
+	}
+
+	/**
+	 * @brief Returns whether any cell is set
+	 * @return whether any cell is set
+	 */
+	[[nodiscard]] constexpr bool any() const {
+		for (unsigned int i = 0; i < WORDS; i++) {
+			if (words[i] != 0) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief Returns whether no cell is set
+	 * @return whether no cell is set
+	 */
+	[[nodiscard]] constexpr bool none() const {
+		return !any();
+	}
+
+	/**
+	 * @brief Returns the number of cells set
+	 * @return the number of cells set
+	 */
+	[[nodiscard]] unsigned int count() const {
+		unsigned int total = 0;
+		for (unsigned int i = 0; i < WORDS; i++) {
+			total += popcount(words[i]);
+		}
+
+		return total;
+	}
+
+	/**
+	 * @brief Returns the index of the lowest cell set, only valid if any cell is set
+	 * @return the index of the lowest cell set
+	 */
+	[[nodiscard]] unsigned int lowest() const {
+		for (unsigned int i = 0; i < WORDS; i++) {
+			if (words[i] != 0) {
+				return i * 64 + trailingZeros(words[i]);
+			}
+		}
+
+		return AREA<SIDE_LENGTH>;
+	}
+
+	/**
+	 * @brief Clears and returns the index of the lowest cell set, only valid if any cell is set
+	 * @return the index of the lowest cell set
+	 */
+	unsigned int popLowest() {
+		for (unsigned int i = 0; i < WORDS; i++) {
+			if (words[i] != 0) {
+				const unsigned int index = i * 64 + trailingZeros(words[i]);
+				words[i] &= words[i] - 1;
+				return index;
+			}
+		}
+
+		return AREA<SIDE_LENGTH>;
+	}
+
+	constexpr Bitboard operator&(const Bitboard& other) const {
+		Bitboard result;
+		for (unsigned int i = 0; i < WORDS; i++) {
+			result.words[i] = words[i] & other.words[i];
+		}
+		return result;
+	}
+
+	constexpr Bitboard operator|(const Bitboard& other) const {
+		Bitboard result;
+		for (unsigned int i = 0; i < WORDS; i++) {
+			result.words[i] = words[i] | other.words[i];
+		}
+		return result;
+	}
+
+	constexpr Bitboard operator^(const Bitboard& other) const {
+		Bitboard result;
+		for (unsigned int i = 0; i < WORDS; i++) {
+			result.words[i] = words[i] ^ other.words[i];
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Returns the complement of this bitboard, which includes bits past the end of the board
+	 * @return the complement of this bitboard
+	 */
+	constexpr Bitboard operator~() const {
+		Bitboard result;
+		for (unsigned int i = 0; i < WORDS; i++) {
+			result.words[i] = ~words[i];
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Shifts every cell up by the given amount of indices, which must be less than 64
+	 * @param amount number of indices to shift by
+	 * @return shifted bitboard
+	 */
+	constexpr Bitboard operator<<(const unsigned int amount) const {
+		Bitboard result;
+		for (unsigned int i = WORDS; i-- > 0;) {
+			result.words[i] = words[i] << amount;
+			if (i > 0) {
+				result.words[i] |= words[i - 1] >> (64 - amount);
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Shifts every cell down by the given amount of indices, which must be less than 64
+	 * @param amount number of indices to shift by
+	 * @return shifted bitboard
+	 */
+	constexpr Bitboard operator>>(const unsigned int amount) const {
+		Bitboard result;
+		for (unsigned int i = 0; i < WORDS; i++) {
+			result.words[i] = words[i] >> amount;
+			if (i + 1 < WORDS) {
+				result.words[i] |= words[i + 1] << (64 - amount);
+			}
+		}
+		return result;
+	}
+
+	constexpr Bitboard& operator&=(const Bitboard& other) {
+		return *this = *this & other;
+	}
+
+	constexpr Bitboard& operator|=(const Bitboard& other) {
+		return *this = *this | other;
+	}
+
+	constexpr Bitboard& operator^=(const Bitboard& other) {
+		return *this = *this ^ other;
+	}
+
+	constexpr bool operator==(const Bitboard& other) const {
+		for (unsigned int i = 0; i < WORDS; i++) {
+			if (words[i] != other.words[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr bool operator!=(const Bitboard& other) const {
+		return !(*this == other);
+	}
+private:
+	/**
+	 * @brief Returns the number of bits set in a word
+	 * @param word word to count
+	 * @return the number of bits set
+	 */
+	static unsigned int popcount(const uint64_t word) {
+#if defined(_MSC_VER)
+		return static_cast<unsigned int>(__popcnt64(word));
+#else
+		return static_cast<unsigned int>(__builtin_popcountll(word));
+#endif
+	}
+
+	/**
+	 * @brief Returns the index of the lowest bit set in a nonzero word
+	 * @param word word to check
+	 * @return the index of the lowest bit set
+	 */
+	static unsigned int trailingZeros(const uint64_t word) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<unsigned int>(index);
+#else
+		return static_cast<unsigned int>(__builtin_ctzll(word));
+#endif
+	}
+
+	/**
+	 * @brief Bits for each cell with cell i stored in bit i % 64 of word i / 64
+	 */
+	std::array<uint64_t, WORDS> words;
+};
+
+/**
+ * @brief Returns a bitboard with every cell of the board set
+ * @return a bitboard with every cell of the board set
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr Bitboard<SIDE_LENGTH> getBoardMask() {
+	Bitboard<SIDE_LENGTH> mask;
+	for (unsigned int index = 0; index < AREA<SIDE_LENGTH>; index++) {
+		mask.set(index);
+	}
+
+	return mask;
+}
+
+/**
+ * @brief Returns a bitboard with every cell at the given position in its column set
+ * @param offset position in column (index % SIDE_LENGTH)
+ * @return a bitboard with every cell at the given position in its column set
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr Bitboard<SIDE_LENGTH> getEdgeMask(const unsigned int offset) {
+	Bitboard<SIDE_LENGTH> mask;
+	for (unsigned int index = offset; index < AREA<SIDE_LENGTH>; index += SIDE_LENGTH) {
+		mask.set(index);
+	}
+
+	return mask;
+}
+
+/**
+ * @brief Every cell on the board
+ */
+template <unsigned int SIDE_LENGTH>
+inline constexpr Bitboard<SIDE_LENGTH> BOARD_MASK = getBoardMask<SIDE_LENGTH>();
+/**
+ * @brief Cells without a neighbor at index - 1
+ */
+template <unsigned int SIDE_LENGTH>
+inline constexpr Bitboard<SIDE_LENGTH> LOW_EDGE_MASK = getEdgeMask<SIDE_LENGTH>(0);
+/**
+ * @brief Cells without a neighbor at index + 1
+ */
+template <unsigned int SIDE_LENGTH>
+inline constexpr Bitboard<SIDE_LENGTH> HIGH_EDGE_MASK = getEdgeMask<SIDE_LENGTH>(SIDE_LENGTH - 1);
+
+/**
+ * @brief Returns the given cells along with all of their neighbors
+ * @param bitboard cells to expand
+ * @return the given cells and their neighbors
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr Bitboard<SIDE_LENGTH> expand(const Bitboard<SIDE_LENGTH>& bitboard) {
+	return (bitboard
+		| ((bitboard & ~HIGH_EDGE_MASK<SIDE_LENGTH>) << 1)
+		| ((bitboard & ~LOW_EDGE_MASK<SIDE_LENGTH>) >> 1)
+		| (bitboard << SIDE_LENGTH)
+		| (bitboard >> SIDE_LENGTH)) & BOARD_MASK<SIDE_LENGTH>;
+}
+
+/**
+ * @brief Returns the cells neighboring the given cells, not including the given cells
+ * @param bitboard cells to find the neighbors of
+ * @return the neighbors of the given cells
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr Bitboard<SIDE_LENGTH> neighbors(const Bitboard<SIDE_LENGTH>& bitboard) {
+	return expand(bitboard) & ~bitboard;
+}
+
+/**
+ * @brief Returns an array with the neighbors of each cell
+ * @return an array with the neighbors of each cell
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr std::array<Bitboard<SIDE_LENGTH>, AREA<SIDE_LENGTH>> getNeighborMasks() {
+	std::array<Bitboard<SIDE_LENGTH>, AREA<SIDE_LENGTH>> neighborMasks{};
+	for (unsigned int index = 0; index < AREA<SIDE_LENGTH>; index++) {
+		neighborMasks[index] = neighbors(Bitboard<SIDE_LENGTH>::fromIndex(index));
+	}
+
+	return neighborMasks;
+}
+
+/**
+ * @brief Neighbors of each cell
+ */
+template <unsigned int SIDE_LENGTH>
+inline constexpr std::array<Bitboard<SIDE_LENGTH>, AREA<SIDE_LENGTH>> NEIGHBORS = getNeighborMasks<SIDE_LENGTH>();
+
+/**
+ * @brief Returns every cell in area connected to seed
+ * @param seed cells to start from which should be inside area
+ * @param area cells that can be filled
+ * @return every cell in area connected to seed
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr Bitboard<SIDE_LENGTH> floodFill(const Bitboard<SIDE_LENGTH>& seed, const Bitboard<SIDE_LENGTH>& area) {
+	Bitboard<SIDE_LENGTH> filled = seed;
+	while (true) {
+		const Bitboard<SIDE_LENGTH> next = expand(filled) & area;
+		if (next == filled) {
+			return filled;
+		}
+		filled = next;
+	}
+}
+
+#endif
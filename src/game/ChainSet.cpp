@@ -0,0 +1,85 @@
+#include <utility>
+
+#include "ChainSet.h"
+
+template <unsigned int SIDE_LENGTH>
+ChainSet<SIDE_LENGTH> ChainSet<SIDE_LENGTH>::fromPosition(const Position<SIDE_LENGTH>& position) {
+	ChainSet<SIDE_LENGTH> chainSet{};
+	const Bitboard<SIDE_LENGTH> empty = position.empty();
+	for (const Bitboard<SIDE_LENGTH>* pieces : {&position.black, &position.white}) {
+		Bitboard<SIDE_LENGTH> unvisited = *pieces;
+		while (unvisited.any()) {
+			const unsigned int root = unvisited.lowest();
+			const Bitboard<SIDE_LENGTH> chain = floodFill(Bitboard<SIDE_LENGTH>::fromIndex(root), *pieces);
+			unvisited &= ~chain;
+
+			Bitboard<SIDE_LENGTH> cells = chain;
+			while (cells.any()) {
+				chainSet.roots[cells.popLowest()] = static_cast<uint8_t>(root);
+			}
+			chainSet.stones[root] = chain;
+			chainSet.liberties[root] = neighbors(chain) & empty;
+		}
+	}
+
+	return chainSet;
+}
+
+template <unsigned int SIDE_LENGTH>
+void ChainSet<SIDE_LENGTH>::placePiece(const Position<SIDE_LENGTH>& position, const unsigned int index, const char color, const Bitboard<SIDE_LENGTH>& captures) {
+	const Bitboard<SIDE_LENGTH> moveBit = Bitboard<SIDE_LENGTH>::fromIndex(index);
+	const Bitboard<SIDE_LENGTH>& adjacent = NEIGHBORS<SIDE_LENGTH>[index];
+	const Bitboard<SIDE_LENGTH> friendlyPieces = position.pieces(color);
+
+	//Removes the cell from the liberties of adjacent enemy chains that survive
+	Bitboard<SIDE_LENGTH> adjacentEnemies = adjacent & position.pieces(color == 'O' ? 'X' : 'O') & ~captures;
+	while (adjacentEnemies.any()) {
+		const unsigned int enemyRoot = roots[adjacentEnemies.lowest()];
+		liberties[enemyRoot].reset(index);
+		adjacentEnemies &= ~stones[enemyRoot];
+	}
+
+	//Joins adjacent friendly chains with the new piece, keeping the largest chain's representative
+	unsigned int root = index;
+	roots[index] = static_cast<uint8_t>(index);
+	stones[index] = moveBit;
+	liberties[index] = adjacent & position.empty();
+
+	Bitboard<SIDE_LENGTH> adjacentFriends = adjacent & friendlyPieces;
+	while (adjacentFriends.any()) {
+		unsigned int other = roots[adjacentFriends.lowest()];
+		adjacentFriends &= ~stones[other];
+
+		if (stones[other].count() > stones[root].count()) {
+			std::swap(root, other);
+		}
+		join(root, other);
+	}
+	liberties[root].reset(index);
+
+	//Gives captured cells back as liberties to the chains around them
+	if (captures.any()) {
+		Bitboard<SIDE_LENGTH> aroundCaptures = neighbors(captures) & (friendlyPieces | moveBit);
+		while (aroundCaptures.any()) {
+			const unsigned int friendlyRoot = roots[aroundCaptures.lowest()];
+			liberties[friendlyRoot] |= neighbors(stones[friendlyRoot]) & captures;
+			aroundCaptures &= ~stones[friendlyRoot];
+		}
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+void ChainSet<SIDE_LENGTH>::join(const unsigned int root, const unsigned int other) {
+	Bitboard<SIDE_LENGTH> cells = stones[other];
+	while (cells.any()) {
+		roots[cells.popLowest()] = static_cast<uint8_t>(root);
+	}
+
+	stones[root] |= stones[other];
+	liberties[root] |= liberties[other];
+}
+
+template class ChainSet<5>;
+template class ChainSet<7>;
+template class ChainSet<9>;
+template class ChainSet<13>;
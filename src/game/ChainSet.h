@@ -0,0 +1,70 @@
+#ifndef CHAIN_SET_H
+#define CHAIN_SET_H
+
+#include <array>
+#include <cstdint>
+
+#include "Position.h"
+
+/**
+ * @brief Tracks the chains on a board along with their pieces and liberties, updated incrementally as pieces are placed
+ */
+template <unsigned int SIDE_LENGTH>
+class ChainSet {
+public:
+	/**
+	 * @brief Returns the chains found in a board
+	 * @param position board to find chains in
+	 * @return the chains in the board
+	 */
+	static ChainSet fromPosition(const Position<SIDE_LENGTH>& position);
+
+	/**
+	 * @brief Returns the pieces in the chain containing the piece at index
+	 * @param index cell with a piece
+	 * @return pieces in the chain
+	 */
+	[[nodiscard]] const Bitboard<SIDE_LENGTH>& getStones(const unsigned int index) const {
+		return stones[roots[index]];
+	}
+
+	/**
+	 * @brief Returns the liberties of the chain containing the piece at index
+	 * @param index cell with a piece
+	 * @return liberties of the chain
+	 */
+	[[nodiscard]] const Bitboard<SIDE_LENGTH>& getLiberties(const unsigned int index) const {
+		return liberties[roots[index]];
+	}
+
+	/**
+	 * @brief Updates chains for a piece placed at index
+	 * @param position board before placing the piece
+	 * @param index cell to place piece in
+	 * @param color color of piece placed
+	 * @param captures enemy pieces captured by placing the piece
+	 */
+	void placePiece(const Position<SIDE_LENGTH>& position, unsigned int index, char color, const Bitboard<SIDE_LENGTH>& captures);
+private:
+	/**
+	 * @brief Representative cell of the chain containing each cell, only meaningful for cells with pieces
+	 */
+	std::array<uint8_t, AREA<SIDE_LENGTH>> roots;
+	/**
+	 * @brief Pieces of the chain represented by each cell, only meaningful for representative cells
+	 */
+	std::array<Bitboard<SIDE_LENGTH>, AREA<SIDE_LENGTH>> stones;
+	/**
+	 * @brief Liberties of the chain represented by each cell, only meaningful for representative cells
+	 */
+	std::array<Bitboard<SIDE_LENGTH>, AREA<SIDE_LENGTH>> liberties;
+
+	/**
+	 * @brief Makes root the representative of every piece in the chain represented by other and joins their pieces and liberties
+	 * @param root representative of the chain to keep
+	 * @param other representative of the chain to join into root
+	 */
+	void join(unsigned int root, unsigned int other);
+};
+
+#endif
@@ -4,22 +4,51 @@
 #include "GameState.h"
 
 #include "GameStateConstants.h"
+#include "Zobrist.h"
 
-GameState* GameState::newGame(const char color, const std::string& board, const std::vector<std::string>& previousBoards) {
-	const auto gameState = new GameState;
+template <unsigned int SIDE_LENGTH>
+void* GameState<SIDE_LENGTH>::operator new(const std::size_t size) {
+	return GameStatePool<SIDE_LENGTH>::allocate(nullptr, size);
+}
+
+template <unsigned int SIDE_LENGTH>
+void* GameState<SIDE_LENGTH>::operator new(const std::size_t size, GameStatePool<SIDE_LENGTH>* pool) {
+	return GameStatePool<SIDE_LENGTH>::allocate(pool, size);
+}
+
+template <unsigned int SIDE_LENGTH>
+void GameState<SIDE_LENGTH>::operator delete(void* pointer) {
+	GameStatePool<SIDE_LENGTH>::deallocate(pointer);
+}
+
+template <unsigned int SIDE_LENGTH>
+void GameState<SIDE_LENGTH>::operator delete(void* pointer, GameStatePool<SIDE_LENGTH>*) {
+	GameStatePool<SIDE_LENGTH>::deallocate(pointer);
+}
+
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>* GameState<SIDE_LENGTH>::newGame(const char color, const std::string& board, const std::vector<std::string>& previousBoards, GameStatePool<SIDE_LENGTH>* pool) {
+	const auto gameState = new(pool) GameState(pool);
 	gameState->color = color;
-	gameState->board = board;
-	gameState->passed = std::find(previousBoards.begin(), previousBoards.end(), board) != previousBoards.end();
+	gameState->position = Position<SIDE_LENGTH>::fromString(board);
+	gameState->hash = gameState->position.hash();
+	gameState->chains = ChainSet<SIDE_LENGTH>::fromPosition(gameState->position);
 
-	gameState->previousBoards = previousBoards;
+	for (const std::string& previousBoard : previousBoards) {
+		const Position<SIDE_LENGTH> previousPosition = Position<SIDE_LENGTH>::fromString(previousBoard);
+		gameState->history = PositionHistory<SIDE_LENGTH>::add(gameState->history, previousPosition, previousPosition.hash());
+	}
+
+	gameState->passed = gameState->history != nullptr && gameState->history->contains(gameState->position, gameState->hash);
 
 	return gameState;
 }
 
-std::string GameState::getRandomBoard(std::mt19937_64& rng) {
+template <unsigned int SIDE_LENGTH>
+std::string GameState<SIDE_LENGTH>::getRandomBoard(std::mt19937_64& rng) {
 	std::string board;
 	std::uniform_real_distribution distribution(0.0, 1.0);
-	for (unsigned int i = 0; i < AREA; i++) {
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH>; i++) {
 		const double value = distribution(rng);
 		if (value <= 0.001) {
 			//0.1% chance
@@ -39,11 +68,8 @@ std::string GameState::getRandomBoard(std::mt19937_64& rng) {
 	return board;
 }
 
-char GameState::flipColor(const char color) {
-	return (color == 'O') ? 'X' : 'O';
-}
-
-GameState* GameState::getChild(const unsigned int moveNum, const bool keepChild) {
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>* GameState<SIDE_LENGTH>::getChild(const unsigned int moveNum, const bool keepChild) {
 	if (keepChild) {
 		if (children[moveNum] == nullptr) {
 			children[moveNum] = makeMove(validMoves[moveNum]);
@@ -62,7 +88,22 @@ GameState* GameState::getChild(const unsigned int moveNum, const bool keepChild)
 	return makeMove(validMoves[moveNum]);
 }
 
-std::vector<int>* GameState::getValidMoves() {
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>* GameState<SIDE_LENGTH>::copy(GameStatePool<SIDE_LENGTH>* pool) const {
+	auto const gameState = new(pool) GameState(pool);
+	gameState->position = position;
+	gameState->chains = chains;
+	gameState->history = history;
+	gameState->hash = hash;
+	gameState->passed = passed;
+	gameState->color = color;
+	gameState->endState = endState;
+
+	return gameState;
+}
+
+template <unsigned int SIDE_LENGTH>
+std::pmr::vector<int>* GameState<SIDE_LENGTH>::getValidMoves() {
 	if (!setupMoves) {
 		setup();
 	}
@@ -70,7 +111,8 @@ std::vector<int>* GameState::getValidMoves() {
 	return &validMoves;
 }
 
-bool GameState::isValid(const int move) {
+template <unsigned int SIDE_LENGTH>
+bool GameState<SIDE_LENGTH>::isValid(const int move) {
 	if (!setupMoves) {
 		//Pass is always valid
 		if (move == -1) {
@@ -78,171 +120,157 @@ bool GameState::isValid(const int move) {
 		}
 
 		//Cannot move onto occupied cell
-		if (board[move] != '.') {
+		if (!position.empty().test(move)) {
 			return false;
 		}
 
-		const bool possibleRepeat = std::any_of(previousBoards.begin(), previousBoards.end(),
-			[this, move](auto& previousBoard){return previousBoard[move] == color;});
-
-		//Move is not suicide from adjacent spaces
-		const bool hasAdjacentLiberty = std::any_of(NEIGHBORS[move].begin(), NEIGHBORS[move].end(), 
-			[this](const int neighbor){return board[neighbor] == '.';});
-        if (!possibleRepeat && hasAdjacentLiberty) {
-            return true;
-        }
-
-        //Move is not suicide from adjacent chain
-		const bool hasChainLiberty = std::any_of(NEIGHBORS[move].begin(), NEIGHBORS[move].end(), 
-			[this, move](const int neighbor){return board[neighbor] == color && !isSurrounded(neighbor, move);});
-        if (!possibleRepeat && hasChainLiberty) {
-            return true;
-        }
-
-		//Move is not suicide from killing enemy chain
-		const bool hasKillLiberty = std::any_of(NEIGHBORS[move].begin(), NEIGHBORS[move].end(), 
-			[this, move](const int neighbor){return board[neighbor] == flipColor(color) && isSurrounded(neighbor, move);});
-        if (!possibleRepeat && hasKillLiberty) {
-            return true;
-        }
-
-		//Move is suicide
-		if (!hasAdjacentLiberty && !hasChainLiberty && !hasKillLiberty) {
-			return false;
+		//Move is suicide if it does not kill an enemy chain and its chain has no liberties
+		const Bitboard<SIDE_LENGTH> captures = getCaptures(move);
+		if (captures.none()) {
+			const Bitboard<SIDE_LENGTH> moveBit = Bitboard<SIDE_LENGTH>::fromIndex(move);
+			const Bitboard<SIDE_LENGTH>& adjacent = NEIGHBORS<SIDE_LENGTH>[move];
+
+			bool hasLiberty = (adjacent & position.empty()).any();
+			Bitboard<SIDE_LENGTH> adjacentFriends = adjacent & position.pieces(color);
+			while (!hasLiberty && adjacentFriends.any()) {
+				const unsigned int friendIndex = adjacentFriends.lowest();
+				hasLiberty = (chains.getLiberties(friendIndex) & ~moveBit).any();
+				adjacentFriends &= ~chains.getStones(friendIndex);
+			}
+
+			if (!hasLiberty) {
+				return false;
+			}
 		}
 
 		//Move is not repeat
-		const std::string resultBoard = placePiece(move);
-		if (std::find(previousBoards.begin(), previousBoards.end(), resultBoard) == previousBoards.end()) {
-			return true;
-		}
-        
-        return false;
+		return !isRepeat(getResultHash(move, captures), move, captures);
 	} else {
 		return std::find(validMoves.begin(), validMoves.end(), move) != validMoves.end();
 	}
 }
 
-float GameState::getEndState() const {
+template <unsigned int SIDE_LENGTH>
+float GameState<SIDE_LENGTH>::getEndState() const {
 	return endState;
 }
 
-char GameState::getColor() const {
+template <unsigned int SIDE_LENGTH>
+char GameState<SIDE_LENGTH>::getColor() const {
 	return color;
 }
 
-const std::string* GameState::getBoard() const {
-	return &board;
+template <unsigned int SIDE_LENGTH>
+bool GameState<SIDE_LENGTH>::getPassed() const {
+	return passed;
 }
 
-const std::vector<std::string>* GameState::getPreviousBoards() const {
-	return &previousBoards;
+template <unsigned int SIDE_LENGTH>
+std::string GameState<SIDE_LENGTH>::getBoard() const {
+	return position.toString();
 }
 
-void GameState::printGameState() const {
-	std::cout << *this;
-}
+template <unsigned int SIDE_LENGTH>
+std::vector<std::string> GameState<SIDE_LENGTH>::getPreviousBoards() const {
+	std::vector<std::string> previousBoards;
+	if (history == nullptr) {
+		return previousBoards;
+	}
 
-std::ostream& operator<<(std::ostream& out, const GameState& gameState) {
-	for (int y = static_cast<int>(SIDE_LENGTH) - 1; y >= 0; y--) {
-		for (int x = 0; x < static_cast<int>(SIDE_LENGTH); x++) {
-			out << gameState.board[x * SIDE_LENGTH + y];
-		}
-		out << '\n';
+	previousBoards.reserve(history->size());
+	for (const PositionHistory<SIDE_LENGTH>* entry = history.get(); entry != nullptr; entry = entry->getPrevious()) {
+		previousBoards.emplace_back(entry->getPosition().toString());
 	}
+	std::reverse(previousBoards.begin(), previousBoards.end());
+
+	return previousBoards;
+}
+
+template <unsigned int SIDE_LENGTH>
+const Position<SIDE_LENGTH>* GameState<SIDE_LENGTH>::getPosition() const {
+	return &position;
+}
+
+template <unsigned int SIDE_LENGTH>
+uint64_t GameState<SIDE_LENGTH>::getHash() const {
+	return hash;
+}
+
+template <unsigned int SIDE_LENGTH>
+const PositionHistory<SIDE_LENGTH>* GameState<SIDE_LENGTH>::getHistory() const {
+	return history.get();
+}
 
-	return out;
+template <unsigned int SIDE_LENGTH>
+void GameState<SIDE_LENGTH>::printGameState() const {
+	std::cout << *this;
 }
 
-bool GameState::isSurrounded(const unsigned int startIndex, const unsigned int ignoreIndex) const {
-	auto const visitedBoard = new bool[AREA];
-	for (unsigned int i = 0; i < AREA; i++) {
-		visitedBoard[i] = false;
+template <unsigned int SIDE_LENGTH>
+Bitboard<SIDE_LENGTH> GameState<SIDE_LENGTH>::getCaptures(const unsigned int index) const {
+	const Bitboard<SIDE_LENGTH> moveBit = Bitboard<SIDE_LENGTH>::fromIndex(index);
+
+	Bitboard<SIDE_LENGTH> captures;
+	Bitboard<SIDE_LENGTH> adjacentEnemies = NEIGHBORS<SIDE_LENGTH>[index] & position.pieces(flipColor(color));
+	while (adjacentEnemies.any()) {
+		const unsigned int enemyIndex = adjacentEnemies.lowest();
+		adjacentEnemies &= ~chains.getStones(enemyIndex);
+
+		//Chain is destroyed if the move takes its last liberty
+		if (chains.getLiberties(enemyIndex) == moveBit) {
+			captures |= chains.getStones(enemyIndex);
+		}
 	}
-	visitedBoard[ignoreIndex] = true;
-
-	const char color = board[startIndex];
-    std::vector<unsigned int> stack = {startIndex};
-
-    while (!stack.empty()) {
-        const unsigned int curIndex = stack.back();
-		stack.pop_back();
-
-        if (visitedBoard[curIndex]) {
-            continue;
-        }
-        visitedBoard[curIndex] = true;
-
-        if (board[curIndex] == '.') {
-			//Chain is not surrounded
-			delete[] visitedBoard;
-            return false;
-        } else if (board[curIndex] == color) {
-            for (const unsigned int neighbor : NEIGHBORS[curIndex]) {
-                stack.emplace_back(neighbor);
-            }
-        }
-    }
 
-	delete[] visitedBoard;
-	return true;
+	return captures;
 }
 
-void GameState::attemptDestroyChain(std::string& board, const unsigned int index) {
-	auto const visitedBoard = new bool[AREA];
-	for (unsigned int i = 0; i < AREA; i++) {
-		visitedBoard[i] = false;
+template <unsigned int SIDE_LENGTH>
+bool GameState<SIDE_LENGTH>::isRepeat(const uint64_t resultHash, const unsigned int index, const Bitboard<SIDE_LENGTH>& captures) const {
+	if (history == nullptr || !history->containsHash(resultHash)) {
+		return false;
 	}
 
-	const char color = board[index];
-    std::vector<unsigned int> stack = {index};
-    std::vector<unsigned int> chain = {};
-
-    while (!stack.empty()) {
-        const unsigned int curIndex = stack.back();
-		stack.pop_back();
-
-        if (visitedBoard[curIndex]) {
-            continue;
-        }
-        visitedBoard[curIndex] = true;
-
-        if (board[curIndex] == '.') {
-			//Chain cannot be destroyed
-			delete[] visitedBoard;
-            return;
-        } else if (board[curIndex] == color) {
-            chain.emplace_back(curIndex);
-            for (const unsigned int neighbor : NEIGHBORS[curIndex]) {
-                stack.emplace_back(neighbor);
-            }
-        }
-    }
+	//Compares full boards in case of a hash collision
+	return history->contains(placePiece(index, captures), resultHash);
+}
 
-    for (const int enemyIndex : chain) {
-        board[enemyIndex] = '.';
-    }
+template <unsigned int SIDE_LENGTH>
+uint64_t GameState<SIDE_LENGTH>::getResultHash(const unsigned int index, const Bitboard<SIDE_LENGTH>& captures) const {
+	return hash ^ getPieceKeys<SIDE_LENGTH>(color)[index] ^ hashCells(captures, getPieceKeys<SIDE_LENGTH>(flipColor(color)));
+}
 
-	delete[] visitedBoard;
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>::GameState(GameStatePool<SIDE_LENGTH>* pool) :
+	pool(pool),
+	validMoves(pool == nullptr ? std::pmr::new_delete_resource() : &pool->resource),
+	children(pool == nullptr ? std::pmr::new_delete_resource() : &pool->resource) {
 }
 
-GameState::~GameState() {
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>::~GameState() {
 	for (const GameState* child : children) {
 		delete child;
 	}
 }
 
-GameState* GameState::makeMove(const int move) const {
-	auto const child = new GameState;
+template <unsigned int SIDE_LENGTH>
+GameState<SIDE_LENGTH>* GameState<SIDE_LENGTH>::makeMove(const int move) const {
+	auto const child = new(pool) GameState(pool);
 
 	child->color = flipColor(color);
-	child->previousBoards = previousBoards;
-	child->previousBoards.emplace_back(board);
+	child->history = PositionHistory<SIDE_LENGTH>::add(history, position, hash);
 	if (move != -1) {
-		child->board = placePiece(move);
+		const Bitboard<SIDE_LENGTH> captures = getCaptures(move);
+		child->position = placePiece(move, captures);
+		child->hash = getResultHash(move, captures);
+		child->chains = chains;
+		child->chains.placePiece(position, move, color, captures);
 		child->passed = false;
     } else {
-		child->board = board;
+		child->position = position;
+		child->hash = hash;
+		child->chains = chains;
 	    child->passed = true;
 
 		if (passed) {
@@ -253,24 +281,29 @@ GameState* GameState::makeMove(const int move) const {
 	return child;
 }
 
-std::string GameState::placePiece(const unsigned int index) const {
-	std::string newBoard = board;
-	newBoard[index] = color;
-
-	const char enemyColor = flipColor(color);
-	for (const unsigned int neighbor : NEIGHBORS[index]) {
-		if (newBoard[neighbor] == enemyColor) {
-			attemptDestroyChain(newBoard, neighbor);
-		}
-	}
+template <unsigned int SIDE_LENGTH>
+Position<SIDE_LENGTH> GameState<SIDE_LENGTH>::placePiece(const unsigned int index, const Bitboard<SIDE_LENGTH>& captures) const {
+	Position<SIDE_LENGTH> newPosition = position;
+	newPosition.pieces(flipColor(color)) &= ~captures;
+	newPosition.pieces(color).set(index);
 
-	return newBoard;
+	return newPosition;
 }
 
-void GameState::setup() {
-	for (int i = -1; i < static_cast<int>(AREA); i++) {
-		if (isValid(i)) {
-			validMoves.emplace_back(i);
+template <unsigned int SIDE_LENGTH>
+void GameState<SIDE_LENGTH>::setup() {
+	Bitboard<SIDE_LENGTH> candidates = position.empty();
+
+	//Reserves enough for every candidate so the lists are allocated once
+	validMoves.reserve(candidates.count() + 1);
+	children.reserve(candidates.count() + 1);
+	validMoves.emplace_back(-1);
+	children.emplace_back(nullptr);
+
+	while (candidates.any()) {
+		const int move = static_cast<int>(candidates.popLowest());
+		if (isValid(move)) {
+			validMoves.emplace_back(move);
 			children.emplace_back(nullptr);
 		}
 	}
@@ -278,82 +311,12 @@ void GameState::setup() {
 	setupMoves = true;
 }
 
-void GameState::endGame() {
-	float whitePoints = 0, blackPoints = 0;
-
-    auto const visitedBoard = new bool[AREA];
-	for (unsigned int i = 0; i < AREA; i++) {
-		if (board[i] == '.') {
-			visitedBoard[i] = false;
-		} else {
-			visitedBoard[i] = true;
-
-			if (board[i] == 'O') {
-	            whitePoints++;
-	        } else if (board[i] == 'X') {
-	            blackPoints++;
-	        }
-		}
-	}
-
-	if (whitePoints <= 0 && blackPoints <= 0) {
-		endState = 0;
-
-		delete[] visitedBoard;
-		return;
-	}
-    
-    while (true) {
-		int emptyIndex = -1;
-        for (unsigned int i = 0; i < AREA; i++) {
-            if (!visitedBoard[i]) {
-                emptyIndex = static_cast<int>(i);
-                break;
-            }
-        }
-
-        if (emptyIndex == -1) {
-            break;
-        }
-
-        std::vector<unsigned int> stack = {static_cast<unsigned int>(emptyIndex)};
-        float chainLength = 0;
-        bool whiteControl = false;
-        bool blackControl = false;
-
-        while (!stack.empty()) {
-            const unsigned int curIndex = stack.back();
-			stack.pop_back();
-
-            if (board[curIndex] == 'O') {
-                whiteControl = true;
-				continue;
-            } else if (board[curIndex] == 'X') {
-                blackControl = true;
-				continue;
-            }
-
-            if (visitedBoard[curIndex]) {
-                continue;
-            }
-            visitedBoard[curIndex] = true;
-
-            if (board[curIndex] == '.') {
-                chainLength++;
-                for (const unsigned int neighbor : NEIGHBORS[curIndex]) {
-                    stack.emplace_back(neighbor);
-                }
-            }
-        }
-
-        if (whiteControl && !blackControl) {
-            whitePoints += chainLength;
-        } else if (blackControl && !whiteControl) {
-            blackPoints += chainLength;
-        }
-    }
-
-    endState = (whitePoints - blackPoints) / (whitePoints + blackPoints);
-
-	delete[] visitedBoard;
+template <unsigned int SIDE_LENGTH>
+void GameState<SIDE_LENGTH>::endGame() {
+	endState = position.score();
 }
+
+template class GameState<5>;
+template class GameState<7>;
+template class GameState<9>;
+template class GameState<13>;
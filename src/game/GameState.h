@@ -1,10 +1,18 @@
 #ifndef GAME_STATE_H
 #define GAME_STATE_H
 
+#include <iostream>
+#include <memory_resource>
 #include <random>
 #include <string>
 #include <vector>
 
+#include "ChainSet.h"
+#include "GameStatePool.h"
+#include "Position.h"
+#include "PositionHistory.h"
+
+template <unsigned int SIDE_LENGTH>
 class GameState {
 public:
 	//Prevents copying/moving game states
@@ -17,15 +25,44 @@ public:
 	 * @brief Clears up children generated
 	 */
 	~GameState();
+
+	/**
+	 * @brief Allocates a game state from the heap
+	 * @param size size of the game state
+	 * @return memory for the game state
+	 */
+	static void* operator new(std::size_t size);
+
+	/**
+	 * @brief Allocates a game state from the given pool
+	 * @param size size of the game state
+	 * @param pool pool to allocate from or null to allocate from the heap
+	 * @return memory for the game state
+	 */
+	static void* operator new(std::size_t size, GameStatePool<SIDE_LENGTH>* pool);
+
+	/**
+	 * @brief Frees a game state back to the pool or heap it came from
+	 * @param pointer memory of the game state
+	 */
+	static void operator delete(void* pointer);
+
+	/**
+	 * @brief Frees a game state whose constructor threw
+	 * @param pointer memory of the game state
+	 * @param pool pool the game state was allocated from
+	 */
+	static void operator delete(void* pointer, GameStatePool<SIDE_LENGTH>* pool);
 	
 	/**
 	 * @brief Returns a game state created from the given parameters
 	 * @param color color of current player
 	 * @param board current board state
 	 * @param previousBoards list of previous board states
+	 * @param pool pool to allocate the game state and its children from or null to use the heap
 	 * @return a new game state
 	 */
-	static GameState* newGame(char color, const std::string& board,  const std::vector<std::string>& previousBoards = {});
+	static GameState* newGame(char color, const std::string& board,  const std::vector<std::string>& previousBoards = {}, GameStatePool<SIDE_LENGTH>* pool = nullptr);
 
 	/**
 	 * @brief Returns a game board with random elements
@@ -39,7 +76,9 @@ public:
 	 * @param color color to flip
 	 * @return the color opposite the given one
 	 */
-	inline static char flipColor(char color);
+	static char flipColor(const char color) {
+		return (color == 'O') ? 'X' : 'O';
+	}
 
 	/**
 	 * @brief Returns child game state based on playing a given move
@@ -48,12 +87,19 @@ public:
 	 * @return child game state
 	 */
 	GameState* getChild(unsigned int moveNum, bool keepChild = true);
+
+	/**
+	 * @brief Returns a copy of this game state without its children, used to keep a game state when the pool it is in gets reset
+	 * @param pool pool to allocate the copy and its children from or null to use the heap
+	 * @return copy of this game state
+	 */
+	[[nodiscard]] GameState* copy(GameStatePool<SIDE_LENGTH>* pool) const;
 	
 	/**
 	 * @brief Returns a vector with all the valid moves
 	 * @return list of valid moves
 	 */
-	std::vector<int>* getValidMoves();
+	std::pmr::vector<int>* getValidMoves();
 	
 	/**
 	 * @brief Checks whether a move is valid
@@ -75,16 +121,40 @@ public:
 	[[nodiscard]] char getColor() const;
 
 	/**
-	 * @brief Returns the current board
+	 * @brief Returns whether the last move was a pass
+	 * @return whether the last move was a pass
+	 */
+	[[nodiscard]] bool getPassed() const;
+
+	/**
+	 * @brief Returns the current board converted to a string
 	 * @return current board
 	 */
-	[[nodiscard]] const std::string* getBoard() const;
+	[[nodiscard]] std::string getBoard() const;
 
 	/**
-	 * @brief Returns a vector with previous boards
+	 * @brief Returns a vector with previous boards converted to strings, built from the history when called
 	 * @return a vector with previous boards
 	 */
-	[[nodiscard]] const std::vector<std::string>* getPreviousBoards() const;
+	[[nodiscard]] std::vector<std::string> getPreviousBoards() const;
+
+	/**
+	 * @brief Returns the current board as bitboards
+	 * @return current position
+	 */
+	[[nodiscard]] const Position<SIDE_LENGTH>* getPosition() const;
+
+	/**
+	 * @brief Returns the Zobrist hash of the current board
+	 * @return hash of the current board
+	 */
+	[[nodiscard]] uint64_t getHash() const;
+
+	/**
+	 * @brief Returns the history of previous boards starting with the most recent one
+	 * @return history of previous boards or null if there are none
+	 */
+	[[nodiscard]] const PositionHistory<SIDE_LENGTH>* getHistory() const;
 	
 	/**
 	 * @brief Prints the game state to console
@@ -97,25 +167,48 @@ public:
 	 * @param gameState game state to print
 	 * @return output stream
 	 */
-	friend std::ostream& operator<<(std::ostream& out, const GameState& gameState);
+	friend std::ostream& operator<<(std::ostream& out, const GameState& gameState) {
+		for (int y = static_cast<int>(SIDE_LENGTH) - 1; y >= 0; y--) {
+			for (int x = 0; x < static_cast<int>(SIDE_LENGTH); x++) {
+				out << gameState.position.at(x * SIDE_LENGTH + y);
+			}
+			out << '\n';
+		}
+
+		return out;
+	}
 private:
-	//Prevents constructor from being used outside GameState and subclasses
-	GameState() = default;
+	friend class GameStatePool<SIDE_LENGTH>;
+
+	/**
+	 * @brief Constructs an empty game state, which is prevented from being used outside GameState and subclasses
+	 * @param pool pool the game state is allocated from, which its children and lists are also allocated from
+	 */
+	explicit GameState(GameStatePool<SIDE_LENGTH>* pool);
+
+	/**
+	 * @brief Returns the enemy pieces that would be captured by the current player placing a piece at index
+	 * @param index position to place piece
+	 * @return enemy pieces that would be captured
+	 */
+	[[nodiscard]] Bitboard<SIDE_LENGTH> getCaptures(unsigned int index) const;
 
 	/**
-	 * @brief Returns whether the given chain is surrounded
-	 * @param startIndex index of member of chain
-	 * @param ignoreIndex index of cell to ignore (very useful, trust me)
-	 * @return whether the given chain is surrounded
+	 * @brief Returns whether the board with the given hash made by placing a piece at index was already played
+	 * @param resultHash hash of the resulting board
+	 * @param index position to place piece
+	 * @param captures enemy pieces captured by placing the piece
+	 * @return whether the resulting board is a repeat
 	 */
-	[[nodiscard]] bool isSurrounded(unsigned int startIndex, unsigned int ignoreIndex) const;
+	[[nodiscard]] bool isRepeat(uint64_t resultHash, unsigned int index, const Bitboard<SIDE_LENGTH>& captures) const;
 
 	/**
-	 * @brief Checks if the chain at the given index has no liberties and if it does destroys it
-	 * @param board board to check
-	 * @param index index of member of chain
+	 * @brief Returns the hash of the board resulting from placing a piece at index
+	 * @param index position to place piece
+	 * @param captures enemy pieces captured by placing the piece
+	 * @return hash of the resulting board
 	 */
-	static void attemptDestroyChain(std::string& board, unsigned int index);
+	[[nodiscard]] uint64_t getResultHash(unsigned int index, const Bitboard<SIDE_LENGTH>& captures) const;
 
 	/**
 	 * @brief Returns child game state based on playing a given move
@@ -127,9 +220,10 @@ private:
 	/**
 	 * @brief Places piece of current color at index and returns resulting board
 	 * @param index position to place piece
+	 * @param captures enemy pieces captured by placing the piece
 	 * @return Board resulting from placing a piece
 	 */
-	[[nodiscard]] std::string placePiece(const unsigned int index) const;
+	[[nodiscard]] Position<SIDE_LENGTH> placePiece(unsigned int index, const Bitboard<SIDE_LENGTH>& captures) const;
 
 	/**
 	 * @brief Populates validMoves and children
@@ -142,13 +236,21 @@ private:
 	void endGame();
 
 	/**
-	 * @brief Game board with X marking black, O marking white, . marking empty, and # marking a wall
+	 * @brief Game board stored as bitboards for black, white, and walls
 	 */
-	std::string board;
+	Position<SIDE_LENGTH> position;
 	/**
-	 * @brief Previous game boards
+	 * @brief Chains on the current board along with their liberties
 	 */
-	std::vector<std::string> previousBoards;
+	ChainSet<SIDE_LENGTH> chains;
+	/**
+	 * @brief Previous game boards, shared with the parent game state
+	 */
+	std::shared_ptr<const PositionHistory<SIDE_LENGTH>> history;
+	/**
+	 * @brief Zobrist hash of the current board
+	 */
+	uint64_t hash = 0;
 	/**
 	 * @brief Whether the last move was a pass
 	 */
@@ -165,14 +267,18 @@ private:
 	 * @brief Whether valid moves has been populated
 	 */
 	bool setupMoves = false;
+	/**
+	 * @brief Pool this game state and its children are allocated from or null if they are allocated from the heap
+	 */
+	GameStatePool<SIDE_LENGTH>* pool;
 	/**
 	 * @brief List of valid moves
 	 */
-	std::vector<int> validMoves;
+	std::pmr::vector<int> validMoves;
 	/**
 	 * @brief Children game states
 	 */
-	std::vector<GameState*> children;
+	std::pmr::vector<GameState*> children;
 };
 
 #endif
\ No newline at end of file
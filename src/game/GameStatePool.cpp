@@ -0,0 +1,86 @@
+#include <new>
+
+#include "GameStatePool.h"
+
+#include "GameState.h"
+
+template <unsigned int SIDE_LENGTH>
+GameStatePool<SIDE_LENGTH>::GameStatePool() : sentinel{nullptr, &sentinel, &sentinel} {
+}
+
+template <unsigned int SIDE_LENGTH>
+GameStatePool<SIDE_LENGTH>::~GameStatePool() {
+	reset();
+}
+
+template <unsigned int SIDE_LENGTH>
+void GameStatePool<SIDE_LENGTH>::reset() {
+	//Clears every child list first so destroying a game state does not delete its subtree one game state at a time
+	for (Header* header = sentinel.next; header != &sentinel; header = header->next) {
+		reinterpret_cast<GameState<SIDE_LENGTH>*>(header + 1)->children.clear();
+	}
+
+	Header* header = sentinel.next;
+	while (header != &sentinel) {
+		Header* next = header->next;
+		reinterpret_cast<GameState<SIDE_LENGTH>*>(header + 1)->~GameState();
+		header = next;
+	}
+
+	sentinel.previous = &sentinel;
+	sentinel.next = &sentinel;
+	count = 0;
+	resource.release();
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t GameStatePool<SIDE_LENGTH>::size() const {
+	return count;
+}
+
+template <unsigned int SIDE_LENGTH>
+void* GameStatePool<SIDE_LENGTH>::allocate(GameStatePool* pool, const size_t size) {
+	Header* header;
+	if (pool == nullptr) {
+		header = static_cast<Header*>(::operator new(sizeof(Header) + size));
+		header->previous = nullptr;
+		header->next = nullptr;
+	} else {
+		header = static_cast<Header*>(pool->resource.allocate(sizeof(Header) + size, alignof(Header)));
+
+		//Links to the end of the pool's list
+		header->previous = pool->sentinel.previous;
+		header->next = &pool->sentinel;
+		pool->sentinel.previous->next = header;
+		pool->sentinel.previous = header;
+		pool->count++;
+	}
+	header->pool = pool;
+
+	return header + 1;
+}
+
+template <unsigned int SIDE_LENGTH>
+void GameStatePool<SIDE_LENGTH>::deallocate(void* pointer) {
+	Header* header = getHeader(pointer);
+	GameStatePool* pool = header->pool;
+	if (pool == nullptr) {
+		::operator delete(header);
+		return;
+	}
+
+	header->previous->next = header->next;
+	header->next->previous = header->previous;
+	pool->count--;
+	pool->resource.deallocate(header, sizeof(Header) + sizeof(GameState<SIDE_LENGTH>), alignof(Header));
+}
+
+template <unsigned int SIDE_LENGTH>
+typename GameStatePool<SIDE_LENGTH>::Header* GameStatePool<SIDE_LENGTH>::getHeader(void* pointer) {
+	return static_cast<Header*>(pointer) - 1;
+}
+
+template class GameStatePool<5>;
+template class GameStatePool<7>;
+template class GameStatePool<9>;
+template class GameStatePool<13>;
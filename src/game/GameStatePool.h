@@ -0,0 +1,100 @@
+#ifndef GAME_STATE_POOL_H
+#define GAME_STATE_POOL_H
+
+#include <cstddef>
+#include <memory_resource>
+
+template <unsigned int SIDE_LENGTH>
+class GameState;
+
+/**
+ * @brief Owns the game states of a search tree along with their move and child lists, so the whole tree can be released at once
+ *
+ * Memory is handed out from slabs grouped by size and reused when a game state is deleted. The pool is not thread safe, so each search should use its own.
+ */
+template <unsigned int SIDE_LENGTH>
+class GameStatePool {
+public:
+	/**
+	 * @brief Constructs an empty pool
+	 */
+	GameStatePool();
+
+	//Prevents copying/moving pools since game states point to their pool
+	GameStatePool(const GameStatePool& other) = delete;
+	GameStatePool& operator=(const GameStatePool& other) = delete;
+	GameStatePool(const GameStatePool&& other) = delete;
+	GameStatePool& operator=(const GameStatePool&& other) = delete;
+
+	/**
+	 * @brief Destroys every game state still in the pool and frees its slabs
+	 */
+	~GameStatePool();
+
+	/**
+	 * @brief Destroys every game state in the pool at once and frees its slabs, invalidating all pointers to them
+	 */
+	void reset();
+
+	/**
+	 * @brief Returns the number of game states currently in the pool
+	 * @return the number of game states in the pool
+	 */
+	[[nodiscard]] size_t size() const;
+private:
+	friend class GameState<SIDE_LENGTH>;
+
+	/**
+	 * @brief Stored in front of every game state to find the pool it came from and to link the game states in the pool together
+	 */
+	struct alignas(std::max_align_t) Header {
+		/**
+		 * @brief Pool the game state came from or null if it came from the heap
+		 */
+		GameStatePool* pool;
+		/**
+		 * @brief Previous game state in the pool
+		 */
+		Header* previous;
+		/**
+		 * @brief Next game state in the pool
+		 */
+		Header* next;
+	};
+
+	/**
+	 * @brief Returns memory for a game state of the given size, which is freed with deallocate
+	 * @param pool pool to allocate from or null to allocate from the heap
+	 * @param size size of the game state
+	 * @return memory for the game state
+	 */
+	static void* allocate(GameStatePool* pool, size_t size);
+
+	/**
+	 * @brief Frees memory returned by allocate
+	 * @param pointer memory to free
+	 */
+	static void deallocate(void* pointer);
+
+	/**
+	 * @brief Returns the header in front of a game state
+	 * @param pointer memory of the game state
+	 * @return header of the game state
+	 */
+	static Header* getHeader(void* pointer);
+
+	/**
+	 * @brief Memory resource used for game states and their lists
+	 */
+	std::pmr::unsynchronized_pool_resource resource;
+	/**
+	 * @brief Start and end of the list of game states in the pool
+	 */
+	Header sentinel;
+	/**
+	 * @brief Number of game states in the pool
+	 */
+	size_t count = 0;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "Position.h"
+
+#include "Zobrist.h"
+
+template <unsigned int SIDE_LENGTH>
+Position<SIDE_LENGTH> Position<SIDE_LENGTH>::fromString(const std::string& board) {
+	Position<SIDE_LENGTH> position;
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH> && i < board.size(); i++) {
+		if (board[i] == 'X') {
+			position.black.set(i);
+		} else if (board[i] == 'O') {
+			position.white.set(i);
+		} else if (board[i] == '#') {
+			position.walls.set(i);
+		}
+	}
+
+	return position;
+}
+
+template <unsigned int SIDE_LENGTH>
+std::string Position<SIDE_LENGTH>::toString() const {
+	std::string board;
+	board.reserve(AREA<SIDE_LENGTH>);
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH>; i++) {
+		board.push_back(at(i));
+	}
+
+	return board;
+}
+
+template <unsigned int SIDE_LENGTH>
+char Position<SIDE_LENGTH>::at(const unsigned int index) const {
+	if (black.test(index)) {
+		return 'X';
+	} else if (white.test(index)) {
+		return 'O';
+	} else if (walls.test(index)) {
+		return '#';
+	}
+
+	return '.';
+}
+
+template <unsigned int SIDE_LENGTH>
+uint64_t Position<SIDE_LENGTH>::hash() const {
+	return hashCells(black, ZOBRIST_KEYS<SIDE_LENGTH>.black) ^ hashCells(white, ZOBRIST_KEYS<SIDE_LENGTH>.white) ^ hashCells(walls, ZOBRIST_KEYS<SIDE_LENGTH>.walls);
+}
+
+template <unsigned int SIDE_LENGTH>
+float Position<SIDE_LENGTH>::score() const {
+	const unsigned int whiteStones = white.count();
+	const unsigned int blackStones = black.count();
+
+	if (whiteStones == 0 && blackStones == 0) {
+		return 0;
+	}
+
+	//Fills every empty region touching each color at once, so regions touching only one color are that color's territory
+	const Bitboard<SIDE_LENGTH> emptyCells = empty();
+	const Bitboard<SIDE_LENGTH> whiteReach = floodFill(neighbors(white) & emptyCells, emptyCells);
+	const Bitboard<SIDE_LENGTH> blackReach = floodFill(neighbors(black) & emptyCells, emptyCells);
+
+	const auto whitePoints = static_cast<float>(whiteStones + (whiteReach & ~blackReach).count());
+	const auto blackPoints = static_cast<float>(blackStones + (blackReach & ~whiteReach).count());
+
+	return (whitePoints - blackPoints) / (whitePoints + blackPoints);
+}
+
+template struct Position<5>;
+template struct Position<7>;
+template struct Position<9>;
+template struct Position<13>;
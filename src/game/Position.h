@@ -0,0 +1,93 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <string>
+
+#include "Bitboard.h"
+
+/**
+ * @brief Board contents stored as one bitboard for each kind of cell
+ */
+template <unsigned int SIDE_LENGTH>
+struct Position {
+	/**
+	 * @brief Cells with black pieces
+	 */
+	Bitboard<SIDE_LENGTH> black;
+	/**
+	 * @brief Cells with white pieces
+	 */
+	Bitboard<SIDE_LENGTH> white;
+	/**
+	 * @brief Cells with walls
+	 */
+	Bitboard<SIDE_LENGTH> walls;
+
+	/**
+	 * @brief Returns a position from a game board with X marking black, O marking white, . marking empty, and # marking a wall
+	 * @param board game board to convert
+	 * @return position matching the game board
+	 */
+	static Position fromString(const std::string& board);
+
+	/**
+	 * @brief Returns the game board with X marking black, O marking white, . marking empty, and # marking a wall
+	 * @return game board matching this position
+	 */
+	[[nodiscard]] std::string toString() const;
+
+	/**
+	 * @brief Returns the character of the cell at index using the same characters as game boards
+	 * @param index cell to check
+	 * @return character of the cell
+	 */
+	[[nodiscard]] char at(unsigned int index) const;
+
+	/**
+	 * @brief Returns the Zobrist hash of this position
+	 * @return the Zobrist hash of this position
+	 */
+	[[nodiscard]] uint64_t hash() const;
+
+	/**
+	 * @brief Returns the final score counting pieces and the empty regions bordered by only one color
+	 * @return score from -1 to 1 with 1 being a white wipe and -1 being a black wipe
+	 */
+	[[nodiscard]] float score() const;
+
+	/**
+	 * @brief Returns the empty cells
+	 * @return the empty cells
+	 */
+	[[nodiscard]] constexpr Bitboard<SIDE_LENGTH> empty() const {
+		return ~(black | white | walls) & BOARD_MASK<SIDE_LENGTH>;
+	}
+
+	/**
+	 * @brief Returns the cells with pieces of the given color
+	 * @param color X for black or O for white
+	 * @return the cells with pieces of the given color
+	 */
+	[[nodiscard]] constexpr const Bitboard<SIDE_LENGTH>& pieces(const char color) const {
+		return (color == 'O') ? white : black;
+	}
+
+	/**
+	 * @brief Returns the cells with pieces of the given color
+	 * @param color X for black or O for white
+	 * @return the cells with pieces of the given color
+	 */
+	constexpr Bitboard<SIDE_LENGTH>& pieces(const char color) {
+		return (color == 'O') ? white : black;
+	}
+
+	constexpr bool operator==(const Position& other) const {
+		return black == other.black && white == other.white && walls == other.walls;
+	}
+
+	constexpr bool operator!=(const Position& other) const {
+		return !(*this == other);
+	}
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include "PositionHistory.h"
+
+/**
+ * @brief Maximum number of entries searched one by one before their hashes are merged into a new snapshot
+ */
+constexpr unsigned int SNAPSHOT_INTERVAL = 16;
+
+template <unsigned int SIDE_LENGTH>
+PositionHistory<SIDE_LENGTH>::~PositionHistory() {
+	std::shared_ptr<const PositionHistory<SIDE_LENGTH>> next = std::move(previous);
+	while (next != nullptr && next.use_count() == 1) {
+		std::shared_ptr<const PositionHistory<SIDE_LENGTH>> after = std::move(next->previous);
+		next = std::move(after);
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+std::shared_ptr<const PositionHistory<SIDE_LENGTH>> PositionHistory<SIDE_LENGTH>::add(const std::shared_ptr<const PositionHistory>& previous, const Position<SIDE_LENGTH>& position, const uint64_t hash) {
+	auto const history = std::make_shared<PositionHistory<SIDE_LENGTH>>();
+	history->position = position;
+	history->hash = hash;
+	history->previous = previous;
+
+	if (previous == nullptr) {
+		history->length = 1;
+		history->recentCount = 1;
+	} else if (previous->recentCount < SNAPSHOT_INTERVAL) {
+		history->length = previous->length + 1;
+		history->snapshot = previous->snapshot;
+		history->recentCount = previous->recentCount + 1;
+	} else {
+		//Every entry added after a full interval shares the snapshot merged for it, so adding one stays constant time
+		history->length = previous->length + 1;
+		history->snapshot = previous->getMergedSnapshot();
+		history->recentCount = 1;
+	}
+
+	return history;
+}
+
+template <unsigned int SIDE_LENGTH>
+const std::shared_ptr<const std::vector<uint64_t>>& PositionHistory<SIDE_LENGTH>::getMergedSnapshot() const {
+	std::call_once(mergedSnapshotFlag, [this]() {
+		//Merges recent hashes into a new snapshot
+		std::vector<uint64_t> recentHashes;
+		recentHashes.reserve(recentCount);
+		const PositionHistory<SIDE_LENGTH>* entry = this;
+		for (unsigned int i = 0; i < recentCount; i++) {
+			recentHashes.emplace_back(entry->hash);
+			entry = entry->previous.get();
+		}
+		std::sort(recentHashes.begin(), recentHashes.end());
+
+		auto const merged = std::make_shared<std::vector<uint64_t>>();
+		if (snapshot != nullptr) {
+			merged->reserve(snapshot->size() + recentHashes.size());
+			std::merge(snapshot->begin(), snapshot->end(), recentHashes.begin(), recentHashes.end(), std::back_inserter(*merged));
+		} else {
+			*merged = std::move(recentHashes);
+		}
+
+		mergedSnapshot = merged;
+	});
+
+	return mergedSnapshot;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool PositionHistory<SIDE_LENGTH>::containsHash(const uint64_t hash) const {
+	const PositionHistory<SIDE_LENGTH>* entry = this;
+	for (unsigned int i = 0; i < recentCount; i++) {
+		if (entry->hash == hash) {
+			return true;
+		}
+		entry = entry->previous.get();
+	}
+
+	return snapshot != nullptr && std::binary_search(snapshot->begin(), snapshot->end(), hash);
+}
+
+template <unsigned int SIDE_LENGTH>
+bool PositionHistory<SIDE_LENGTH>::contains(const Position<SIDE_LENGTH>& position, const uint64_t hash) const {
+	if (!containsHash(hash)) {
+		return false;
+	}
+
+	//Compares full boards in case of a hash collision
+	for (const PositionHistory<SIDE_LENGTH>* entry = this; entry != nullptr; entry = entry->previous.get()) {
+		if (entry->hash == hash && entry->position == position) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template <unsigned int SIDE_LENGTH>
+const Position<SIDE_LENGTH>& PositionHistory<SIDE_LENGTH>::getPosition() const {
+	return position;
+}
+
+template <unsigned int SIDE_LENGTH>
+uint64_t PositionHistory<SIDE_LENGTH>::getHash() const {
+	return hash;
+}
+
+template <unsigned int SIDE_LENGTH>
+const PositionHistory<SIDE_LENGTH>* PositionHistory<SIDE_LENGTH>::getPrevious() const {
+	return previous.get();
+}
+
+template <unsigned int SIDE_LENGTH>
+size_t PositionHistory<SIDE_LENGTH>::size() const {
+	return length;
+}
+
+template class PositionHistory<5>;
+template class PositionHistory<7>;
+template class PositionHistory<9>;
+template class PositionHistory<13>;
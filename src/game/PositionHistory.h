@@ -0,0 +1,115 @@
+#ifndef POSITION_HISTORY_H
+#define POSITION_HISTORY_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Position.h"
+
+/**
+ * @brief Immutable list of previous boards where each entry links to the entry before it, so game states can share their parent's history
+ */
+template <unsigned int SIDE_LENGTH>
+class PositionHistory {
+public:
+	/**
+	 * @brief Constructs an entry, use add instead
+	 */
+	PositionHistory() = default;
+
+	/**
+	 * @brief Unlinks older entries one at a time so long histories do not overflow the stack
+	 */
+	~PositionHistory();
+
+	/**
+	 * @brief Returns a new history made of the given history followed by the given board
+	 * @param previous history to add to, which can be null
+	 * @param position board to add
+	 * @param hash Zobrist hash of the board
+	 * @return a new history ending with the given board
+	 */
+	static std::shared_ptr<const PositionHistory> add(const std::shared_ptr<const PositionHistory>& previous, const Position<SIDE_LENGTH>& position, uint64_t hash);
+
+	/**
+	 * @brief Returns whether a board with the given hash might be in the history, which may be a false positive from a hash collision
+	 * @param hash Zobrist hash of the board
+	 * @return whether a board with the given hash might be in the history
+	 */
+	[[nodiscard]] bool containsHash(uint64_t hash) const;
+
+	/**
+	 * @brief Returns whether the given board is in the history
+	 * @param position board to look for
+	 * @param hash Zobrist hash of the board
+	 * @return whether the given board is in the history
+	 */
+	[[nodiscard]] bool contains(const Position<SIDE_LENGTH>& position, uint64_t hash) const;
+
+	/**
+	 * @brief Returns the most recent board
+	 * @return the most recent board
+	 */
+	[[nodiscard]] const Position<SIDE_LENGTH>& getPosition() const;
+
+	/**
+	 * @brief Returns the hash of the most recent board
+	 * @return the hash of the most recent board
+	 */
+	[[nodiscard]] uint64_t getHash() const;
+
+	/**
+	 * @brief Returns the history before the most recent board
+	 * @return the history before the most recent board or null if there is none
+	 */
+	[[nodiscard]] const PositionHistory* getPrevious() const;
+
+	/**
+	 * @brief Returns the number of boards in the history
+	 * @return the number of boards in the history
+	 */
+	[[nodiscard]] size_t size() const;
+private:
+	/**
+	 * @brief Returns the sorted hashes of this entry and every board before it, merging them the first time so every entry added after this one can share them
+	 * @return snapshot covering the whole history
+	 */
+	const std::shared_ptr<const std::vector<uint64_t>>& getMergedSnapshot() const;
+
+	/**
+	 * @brief Most recent board
+	 */
+	Position<SIDE_LENGTH> position;
+	/**
+	 * @brief Zobrist hash of the most recent board
+	 */
+	uint64_t hash = 0;
+	/**
+	 * @brief History before the most recent board, mutable so the destructor can unlink it
+	 */
+	mutable std::shared_ptr<const PositionHistory> previous;
+	/**
+	 * @brief Number of boards in the history
+	 */
+	size_t length = 0;
+	/**
+	 * @brief Sorted hashes of every board older than the recent entries, shared between entries
+	 */
+	std::shared_ptr<const std::vector<uint64_t>> snapshot;
+	/**
+	 * @brief Number of entries starting at this one that are not in the snapshot
+	 */
+	unsigned int recentCount = 0;
+	/**
+	 * @brief Snapshot covering the whole history, merged on first use by getMergedSnapshot
+	 */
+	mutable std::shared_ptr<const std::vector<uint64_t>> mergedSnapshot;
+	/**
+	 * @brief Makes sure the merged snapshot is only built once when several threads add entries after this one
+	 */
+	mutable std::once_flag mergedSnapshotFlag;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include "Zobrist.h"
+
+/**
+ * @brief Fast xoshiro256** random number generator, used by one thread at a time, which standard distributions can draw from
+ *
+ * Each search owns one and hands every thread its own generator split from it, so a search seeded with the same root seed draws the same numbers on each thread.
+ */
+class Random {
+public:
+	using result_type = uint64_t;
+
+	/**
+	 * @brief Constructs a generator seeded from the system's random device
+	 */
+	Random() {
+		std::random_device seeder;
+		seed(static_cast<uint64_t>(seeder()) << 32 | seeder());
+	}
+
+	/**
+	 * @brief Constructs a generator seeded with the given seed
+	 * @param seed seed to start from
+	 */
+	explicit Random(const uint64_t seed) {
+		this->seed(seed);
+	}
+
+	/**
+	 * @brief Restarts the generator from the given seed, spreading it over the state with splitmix64 so similar seeds give unrelated streams
+	 * @param seed seed to start from
+	 */
+	void seed(uint64_t seed) {
+		for (uint64_t& word : state) {
+			word = splitMix64(seed);
+		}
+	}
+
+	/**
+	 * @brief Returns the next random number
+	 * @return random unsigned 64 bit integer
+	 */
+	uint64_t operator()() {
+		const uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+		const uint64_t shifted = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = rotateLeft(state[3], 45);
+		return result;
+	}
+
+	/**
+	 * @brief Returns a random number below the given bound by scaling the top 32 bits, which is faster than a distribution and close enough to uniform for small bounds
+	 * @param bound number of possible results, at least 1
+	 * @return random number from 0 to bound - 1
+	 */
+	unsigned int below(const unsigned int bound) {
+		return static_cast<unsigned int>(((*this)() >> 32) * bound >> 32);
+	}
+
+	/**
+	 * @brief Returns a new generator seeded from this one, for handing to another thread
+	 * @return generator with its own stream
+	 */
+	Random split() {
+		return Random((*this)());
+	}
+
+	static constexpr uint64_t min() {
+		return std::numeric_limits<uint64_t>::min();
+	}
+
+	static constexpr uint64_t max() {
+		return std::numeric_limits<uint64_t>::max();
+	}
+private:
+	/**
+	 * @brief Rotates the bits of a number left
+	 * @param value number to rotate
+	 * @param bits number of bits to rotate by, from 1 to 63
+	 * @return rotated number
+	 */
+	static uint64_t rotateLeft(const uint64_t value, const int bits) {
+		return value << bits | value >> (64 - bits);
+	}
+
+	/**
+	 * @brief State of the generator, which seeding never leaves all zero
+	 */
+	uint64_t state[4];
+};
+
+#endif
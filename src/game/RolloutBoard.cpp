@@ -0,0 +1,171 @@
+#include "RolloutBoard.h"
+
+#include "Zobrist.h"
+
+template <unsigned int SIDE_LENGTH>
+RolloutBoard<SIDE_LENGTH>::RolloutBoard(const GameState<SIDE_LENGTH>* gameState) :
+	position(*gameState->getPosition()),
+	hash(gameState->getHash()),
+	color(gameState->getColor()),
+	passed(gameState->getPassed()),
+	over(gameState->getEndState() >= -1),
+	history(gameState->getHistory()) {
+}
+
+template <unsigned int SIDE_LENGTH>
+bool RolloutBoard<SIDE_LENGTH>::isValid(const int move) const {
+	//Pass is always valid
+	if (move == -1) {
+		return true;
+	}
+
+	//Cannot move onto occupied cell
+	const Bitboard<SIDE_LENGTH> empty = position.empty();
+	if (!empty.test(move)) {
+		return false;
+	}
+
+	//Move is suicide if it does not kill an enemy chain and its chain has no liberties
+	const Bitboard<SIDE_LENGTH> moveBit = Bitboard<SIDE_LENGTH>::fromIndex(move);
+	const Bitboard<SIDE_LENGTH> captures = getCaptures(move);
+	if (captures.none() && (NEIGHBORS<SIDE_LENGTH>[move] & empty).none()) {
+		const Bitboard<SIDE_LENGTH> chain = floodFill(moveBit, position.pieces(color) | moveBit);
+		if ((neighbors(chain) & empty).none()) {
+			return false;
+		}
+	}
+
+	//Move is not repeat
+	Position<SIDE_LENGTH> result = position;
+	result.pieces(GameState<SIDE_LENGTH>::flipColor(color)) &= ~captures;
+	result.pieces(color) |= moveBit;
+	const uint64_t resultHash = hash ^ getPieceKeys<SIDE_LENGTH>(color)[move] ^ hashCells(captures, getPieceKeys<SIDE_LENGTH>(GameState<SIDE_LENGTH>::flipColor(color)));
+
+	return !isRepeat(resultHash, result);
+}
+
+template <unsigned int SIDE_LENGTH>
+void RolloutBoard<SIDE_LENGTH>::play(const int move) {
+	plies[plyCount] = {position.black, position.white, hash, passed};
+
+	unsigned int slot = hash & (TABLE_SIZE - 1);
+	while (plyTable[slot] != 0) {
+		slot = (slot + 1) & (TABLE_SIZE - 1);
+	}
+	plyTable[slot] = static_cast<uint16_t>(plyCount + 1);
+	plyCount++;
+
+	if (move == -1) {
+		over = passed;
+		passed = true;
+	} else {
+		const Bitboard<SIDE_LENGTH> captures = getCaptures(move);
+		const char enemy = GameState<SIDE_LENGTH>::flipColor(color);
+		position.pieces(enemy) &= ~captures;
+		position.pieces(color).set(move);
+		hash ^= getPieceKeys<SIDE_LENGTH>(color)[move] ^ hashCells(captures, getPieceKeys<SIDE_LENGTH>(enemy));
+		passed = false;
+	}
+
+	color = GameState<SIDE_LENGTH>::flipColor(color);
+}
+
+template <unsigned int SIDE_LENGTH>
+void RolloutBoard<SIDE_LENGTH>::undo() {
+	plyCount--;
+	const Ply& ply = plies[plyCount];
+
+	//The last board added is the last one in its probe sequence, so clearing its slot restores the table
+	unsigned int slot = ply.hash & (TABLE_SIZE - 1);
+	while (plyTable[slot] != plyCount + 1) {
+		slot = (slot + 1) & (TABLE_SIZE - 1);
+	}
+	plyTable[slot] = 0;
+
+	position.black = ply.black;
+	position.white = ply.white;
+	hash = ply.hash;
+	passed = ply.passed;
+	over = false;
+	color = GameState<SIDE_LENGTH>::flipColor(color);
+}
+
+template <unsigned int SIDE_LENGTH>
+int RolloutBoard<SIDE_LENGTH>::getRandomMove(Random& rng) const {
+	std::array<int, NUM_MOVES<SIDE_LENGTH>> candidates;
+	unsigned int candidateCount = 0;
+	candidates[candidateCount++] = -1;
+	Bitboard<SIDE_LENGTH> empty = position.empty();
+	while (empty.any()) {
+		candidates[candidateCount++] = static_cast<int>(empty.popLowest());
+	}
+
+	//Removes invalid candidates as they are drawn, which keeps the choice uniform over valid moves
+	while (true) {
+		const unsigned int choice = rng.below(candidateCount);
+		const int move = candidates[choice];
+		if (isValid(move)) {
+			return move;
+		}
+
+		candidates[choice] = candidates[--candidateCount];
+	}
+}
+
+template <unsigned int SIDE_LENGTH>
+bool RolloutBoard<SIDE_LENGTH>::isOver() const {
+	return over || plyCount == MAX_PLIES;
+}
+
+template <unsigned int SIDE_LENGTH>
+float RolloutBoard<SIDE_LENGTH>::getScore() const {
+	return position.score();
+}
+
+template <unsigned int SIDE_LENGTH>
+unsigned int RolloutBoard<SIDE_LENGTH>::getPlies() const {
+	return plyCount;
+}
+
+template <unsigned int SIDE_LENGTH>
+Bitboard<SIDE_LENGTH> RolloutBoard<SIDE_LENGTH>::getCaptures(const unsigned int index) const {
+	const Bitboard<SIDE_LENGTH> moveBit = Bitboard<SIDE_LENGTH>::fromIndex(index);
+	const Bitboard<SIDE_LENGTH> empty = position.empty();
+	const Bitboard<SIDE_LENGTH>& enemies = position.pieces(GameState<SIDE_LENGTH>::flipColor(color));
+
+	Bitboard<SIDE_LENGTH> captures;
+	Bitboard<SIDE_LENGTH> adjacentEnemies = NEIGHBORS<SIDE_LENGTH>[index] & enemies;
+	while (adjacentEnemies.any()) {
+		const Bitboard<SIDE_LENGTH> chain = floodFill(Bitboard<SIDE_LENGTH>::fromIndex(adjacentEnemies.lowest()), enemies);
+		adjacentEnemies &= ~chain;
+
+		//Chain is destroyed if the move takes its last liberty
+		if ((neighbors(chain) & empty) == moveBit) {
+			captures |= chain;
+		}
+	}
+
+	return captures;
+}
+
+template <unsigned int SIDE_LENGTH>
+bool RolloutBoard<SIDE_LENGTH>::isRepeat(const uint64_t resultHash, const Position<SIDE_LENGTH>& result) const {
+	//Compares full boards in case of a hash collision
+	if (history != nullptr && history->containsHash(resultHash) && history->contains(result, resultHash)) {
+		return true;
+	}
+
+	for (unsigned int slot = resultHash & (TABLE_SIZE - 1); plyTable[slot] != 0; slot = (slot + 1) & (TABLE_SIZE - 1)) {
+		const Ply& ply = plies[plyTable[slot] - 1];
+		if (ply.hash == resultHash && ply.black == result.black && ply.white == result.white) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template class RolloutBoard<5>;
+template class RolloutBoard<7>;
+template class RolloutBoard<9>;
+template class RolloutBoard<13>;
@@ -0,0 +1,158 @@
+#ifndef ROLLOUT_BOARD_H
+#define ROLLOUT_BOARD_H
+
+#include <array>
+#include <cstdint>
+
+#include "GameState.h"
+#include "Random.h"
+
+/**
+ * @brief Mutable board used to play random games to the end without allocating, which is meant to live on the stack
+ *
+ * Moves are played and undone in place following the same rules as GameState. Rollouts longer than MAX_PLIES moves are scored where they stop.
+ */
+template <unsigned int SIDE_LENGTH>
+class RolloutBoard {
+public:
+	/**
+	 * @brief Maximum number of moves that can be played on the board, several times longer than a typical random game
+	 */
+	static constexpr unsigned int MAX_PLIES = 8 * AREA<SIDE_LENGTH>;
+
+	/**
+	 * @brief Constructs a board starting from the given game state, which is only read
+	 * @param gameState game state to start from
+	 */
+	explicit RolloutBoard(const GameState<SIDE_LENGTH>* gameState);
+
+	/**
+	 * @brief Checks whether a move is valid
+	 * @param move possible move with -1 being a pass
+	 * @return whether the move is valid
+	 */
+	[[nodiscard]] bool isValid(int move) const;
+
+	/**
+	 * @brief Plays a valid move for the current player
+	 * @param move valid move with -1 being a pass
+	 */
+	void play(int move);
+
+	/**
+	 * @brief Takes back the last move played
+	 */
+	void undo();
+
+	/**
+	 * @brief Returns a valid move chosen uniformly at random, including passing
+	 * @param rng random number generator to use
+	 * @return a random valid move
+	 */
+	int getRandomMove(Random& rng) const;
+
+	/**
+	 * @brief Returns whether the game is over because both players passed or the board ran out of moves
+	 * @return whether the game is over
+	 */
+	[[nodiscard]] bool isOver() const;
+
+	/**
+	 * @brief Returns the score of the current board
+	 * @return score from -1 to 1 with 1 being a white wipe and -1 being a black wipe
+	 */
+	[[nodiscard]] float getScore() const;
+
+	/**
+	 * @brief Returns the number of moves played on the board
+	 * @return the number of moves played
+	 */
+	[[nodiscard]] unsigned int getPlies() const;
+private:
+	/**
+	 * @brief Board before a move, kept so the move can be undone and to detect repeated boards
+	 */
+	struct Ply {
+		/**
+		 * @brief Cells with black pieces
+		 */
+		Bitboard<SIDE_LENGTH> black;
+		/**
+		 * @brief Cells with white pieces
+		 */
+		Bitboard<SIDE_LENGTH> white;
+		/**
+		 * @brief Zobrist hash of the board
+		 */
+		uint64_t hash;
+		/**
+		 * @brief Whether the move before was a pass
+		 */
+		bool passed;
+	};
+
+	/**
+	 * @brief Number of slots in the table of previous boards, a power of two at least twice MAX_PLIES
+	 */
+	static constexpr unsigned int TABLE_SIZE = [] {
+		unsigned int size = 1;
+		while (size < 2 * (MAX_PLIES + 1)) {
+			size *= 2;
+		}
+		return size;
+	}();
+
+	/**
+	 * @brief Returns the enemy pieces that would be captured by the current player placing a piece at index
+	 * @param index position to place piece
+	 * @return enemy pieces that would be captured
+	 */
+	[[nodiscard]] Bitboard<SIDE_LENGTH> getCaptures(unsigned int index) const;
+
+	/**
+	 * @brief Returns whether the board with the given hash was already played in the game state's history or on this board
+	 * @param resultHash hash of the resulting board
+	 * @param result resulting board
+	 * @return whether the resulting board is a repeat
+	 */
+	[[nodiscard]] bool isRepeat(uint64_t resultHash, const Position<SIDE_LENGTH>& result) const;
+
+	/**
+	 * @brief Current board
+	 */
+	Position<SIDE_LENGTH> position;
+	/**
+	 * @brief Zobrist hash of the current board
+	 */
+	uint64_t hash;
+	/**
+	 * @brief Current player's color
+	 */
+	char color;
+	/**
+	 * @brief Whether the last move was a pass
+	 */
+	bool passed;
+	/**
+	 * @brief Whether both players passed
+	 */
+	bool over = false;
+	/**
+	 * @brief History of the game state the board started from
+	 */
+	const PositionHistory<SIDE_LENGTH>* history;
+	/**
+	 * @brief Boards before each move played
+	 */
+	std::array<Ply, MAX_PLIES> plies;
+	/**
+	 * @brief Number of moves played
+	 */
+	unsigned int plyCount = 0;
+	/**
+	 * @brief Open addressing table indexed by hash holding one more than the ply of each board before a move, with 0 marking an empty slot
+	 */
+	std::array<uint16_t, TABLE_SIZE> plyTable{};
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <array>
+#include <cstdint>
+
+#include "Position.h"
+#include "Zobrist.h"
+
+/**
+ * @brief Number of rotations and reflections of a square board, counting leaving it as it is
+ */
+constexpr unsigned int SYMMETRY_COUNT = 8;
+
+/**
+ * @brief Generates the cell each cell is moved to by each symmetry, where bit 2 of a symmetry swaps rows with columns, then bit 0 mirrors the rows and bit 1 mirrors the columns
+ * @return cells moved to, indexed by symmetry then cell
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr std::array<std::array<unsigned int, AREA<SIDE_LENGTH>>, SYMMETRY_COUNT> generateSymmetryCells() {
+	std::array<std::array<unsigned int, AREA<SIDE_LENGTH>>, SYMMETRY_COUNT> cells{};
+	for (unsigned int symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry++) {
+		for (unsigned int index = 0; index < AREA<SIDE_LENGTH>; index++) {
+			unsigned int row = index / SIDE_LENGTH;
+			unsigned int column = index % SIDE_LENGTH;
+			if ((symmetry & 4) != 0) {
+				const unsigned int swapped = row;
+				row = column;
+				column = swapped;
+			}
+			if ((symmetry & 1) != 0) {
+				row = SIDE_LENGTH - 1 - row;
+			}
+			if ((symmetry & 2) != 0) {
+				column = SIDE_LENGTH - 1 - column;
+			}
+			cells[symmetry][index] = row * SIDE_LENGTH + column;
+		}
+	}
+
+	return cells;
+}
+
+/**
+ * @brief Cell each cell is moved to by each symmetry
+ */
+template <unsigned int SIDE_LENGTH>
+inline constexpr std::array<std::array<unsigned int, AREA<SIDE_LENGTH>>, SYMMETRY_COUNT> SYMMETRY_CELLS = generateSymmetryCells<SIDE_LENGTH>();
+
+/**
+ * @brief Returns the XOR of the keys for every cell in the given bitboard after moving the cells by a symmetry
+ * @param cells cells to hash
+ * @param keys keys for the kind of piece in the cells
+ * @param symmetry symmetry to move the cells by
+ * @return the XOR of the keys for every moved cell
+ */
+template <unsigned int SIDE_LENGTH>
+uint64_t hashCells(Bitboard<SIDE_LENGTH> cells, const std::array<uint64_t, AREA<SIDE_LENGTH>>& keys, const unsigned int symmetry) {
+	const std::array<unsigned int, AREA<SIDE_LENGTH>>& moved = SYMMETRY_CELLS<SIDE_LENGTH>[symmetry];
+	uint64_t hash = 0;
+	while (cells.any()) {
+		hash ^= keys[moved[cells.popLowest()]];
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Returns the Zobrist hash a position would have after moving it by a symmetry, walls included
+ * @param position position to hash
+ * @param symmetry symmetry to move the position by
+ * @return the Zobrist hash of the moved position
+ */
+template <unsigned int SIDE_LENGTH>
+uint64_t hashPosition(const Position<SIDE_LENGTH>& position, const unsigned int symmetry) {
+	if (symmetry == 0) {
+		return position.hash();
+	}
+
+	return hashCells(position.black, ZOBRIST_KEYS<SIDE_LENGTH>.black, symmetry) ^ hashCells(position.white, ZOBRIST_KEYS<SIDE_LENGTH>.white, symmetry) ^ hashCells(position.walls, ZOBRIST_KEYS<SIDE_LENGTH>.walls, symmetry);
+}
+
+/**
+ * @brief Returns the smallest key of a game state under any symmetry, which all eight of its symmetric variants share
+ * @param getKey given a symmetry and returns the key of the game state after moving it by that symmetry
+ * @param symmetry set to the first symmetry giving the smallest key, which moves the game state to the shared representative
+ * @return the smallest key
+ */
+template <typename KeyFunction>
+uint64_t getCanonicalKey(const KeyFunction& getKey, unsigned int& symmetry) {
+	symmetry = 0;
+	uint64_t canonicalKey = getKey(0);
+	for (unsigned int i = 1; i < SYMMETRY_COUNT; i++) {
+		const uint64_t key = getKey(i);
+		if (key < canonicalKey) {
+			canonicalKey = key;
+			symmetry = i;
+		}
+	}
+
+	return canonicalKey;
+}
+
+/**
+ * @brief Moves move probabilities into the orientation of a symmetry, with passing staying first
+ * @param probabilities move probabilities in the real orientation
+ * @param symmetry symmetry to move the probabilities by
+ * @param moved set to the move probabilities in the orientation of the symmetry
+ */
+template <unsigned int SIDE_LENGTH>
+void applySymmetry(const float* probabilities, const unsigned int symmetry, float* moved) {
+	const std::array<unsigned int, AREA<SIDE_LENGTH>>& cells = SYMMETRY_CELLS<SIDE_LENGTH>[symmetry];
+	moved[0] = probabilities[0];
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH>; i++) {
+		moved[cells[i] + 1] = probabilities[i + 1];
+	}
+}
+
+/**
+ * @brief Moves move probabilities from the orientation of a symmetry back to the real orientation, undoing applySymmetry
+ * @param moved move probabilities in the orientation of the symmetry
+ * @param symmetry symmetry the probabilities were moved by
+ * @param probabilities set to the move probabilities in the real orientation
+ */
+template <unsigned int SIDE_LENGTH>
+void undoSymmetry(const float* moved, const unsigned int symmetry, float* probabilities) {
+	const std::array<unsigned int, AREA<SIDE_LENGTH>>& cells = SYMMETRY_CELLS<SIDE_LENGTH>[symmetry];
+	probabilities[0] = moved[0];
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH>; i++) {
+		probabilities[i + 1] = moved[cells[i] + 1];
+	}
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+#include "Bitboard.h"
+
+/**
+ * @brief Random keys XORed together to hash a position, with one key for each kind of piece on each cell
+ */
+template <unsigned int SIDE_LENGTH>
+struct ZobristKeys {
+	/**
+	 * @brief Keys for black pieces on each cell
+	 */
+	std::array<uint64_t, AREA<SIDE_LENGTH>> black;
+	/**
+	 * @brief Keys for white pieces on each cell
+	 */
+	std::array<uint64_t, AREA<SIDE_LENGTH>> white;
+	/**
+	 * @brief Keys for walls on each cell
+	 */
+	std::array<uint64_t, AREA<SIDE_LENGTH>> walls;
+};
+
+/**
+ * @brief Advances a splitmix64 state and returns the next random number
+ * @param state generator state
+ * @return the next random number
+ */
+constexpr uint64_t splitMix64(uint64_t& state) {
+	state += 0x9E3779B97F4A7C15;
+	uint64_t result = state;
+	result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+	result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+	return result ^ (result >> 31);
+}
+
+/**
+ * @brief Generates Zobrist keys from a fixed seed so hashes are the same between runs
+ * @return Zobrist keys
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr ZobristKeys<SIDE_LENGTH> generateZobristKeys() {
+	ZobristKeys<SIDE_LENGTH> keys{};
+	uint64_t state = 0x5A0B215790 + SIDE_LENGTH;
+	for (unsigned int i = 0; i < AREA<SIDE_LENGTH>; i++) {
+		keys.black[i] = splitMix64(state);
+		keys.white[i] = splitMix64(state);
+		keys.walls[i] = splitMix64(state);
+	}
+
+	return keys;
+}
+
+/**
+ * @brief Zobrist keys used for every position
+ */
+template <unsigned int SIDE_LENGTH>
+inline constexpr ZobristKeys<SIDE_LENGTH> ZOBRIST_KEYS = generateZobristKeys<SIDE_LENGTH>();
+
+/**
+ * @brief Returns the XOR of the keys for every cell in the given bitboard
+ * @param cells cells to hash
+ * @param keys keys for the kind of piece in the cells
+ * @return the XOR of the keys for every cell
+ */
+template <unsigned int SIDE_LENGTH>
+uint64_t hashCells(Bitboard<SIDE_LENGTH> cells, const std::array<uint64_t, AREA<SIDE_LENGTH>>& keys) {
+	uint64_t hash = 0;
+	while (cells.any()) {
+		hash ^= keys[cells.popLowest()];
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Returns the keys for pieces of the given color
+ * @param color X for black or O for white
+ * @return the keys for pieces of the given color
+ */
+template <unsigned int SIDE_LENGTH>
+constexpr const std::array<uint64_t, AREA<SIDE_LENGTH>>& getPieceKeys(const char color) {
+	return (color == 'O') ? ZOBRIST_KEYS<SIDE_LENGTH>.white : ZOBRIST_KEYS<SIDE_LENGTH>.black;
+}
+
+#endif
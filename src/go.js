@@ -32,8 +32,8 @@ export async function main(ns) {
             
 
             const index = parseInt(await response.json(), 10);
-            const x = Math.floor(index / 5);
-            const y = index % 5;
+            const x = Math.floor(index / ns.args[1]);
+            const y = index % ns.args[1];
             
             if (index == -1) {
                 endState = (await ns.go.passTurn())?.type;
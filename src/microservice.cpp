@@ -1,19 +1,250 @@
 #include "game/GameState.h"
-#include "ai/MCTS.h"
+#include "ai/BasicMCTS.h"
+#include "game/GameStatePool.h"
 #include "Listener.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @brief Longest time to search each move for, or 0 for no time limit
+ */
+std::chrono::milliseconds timeLimit(0);
+/**
+ * @brief Most simulations to run each move, or 0 for no simulation limit
+ */
+unsigned int simulationLimit = 5000;
+/**
+ * @brief How each search is split between threads
+ */
+ParallelMode parallelMode = ParallelMode::TREE;
+/**
+ * @brief Number of visits where a move's own value and its all moves as first value are weighted equally, or 0 to search without RAVE
+ */
+unsigned int raveEquivalence = 0;
+/**
+ * @brief Most nodes each search tree can hold, or 0 for no limit
+ */
+size_t nodeLimit = 0;
+/**
+ * @brief Whether searches stop once their best move is decided
+ */
+bool earlyStopping = true;
+/**
+ * @brief Number of entries in the transposition table, or 0 to search without one
+ */
+unsigned int transpositionTableSize = 1 << 16;
+
+/**
+ * @brief Whether to keep searching the opponent's replies between requests
+ */
+bool ponder = false;
+/**
+ * @brief Most simulations to ponder for after each move, which also bounds how much the kept tree grows while waiting
+ */
+constexpr unsigned int PONDER_SIMULATIONS = 50000;
+
+/**
+ * @brief Search kept between requests for boards with the given side length, so a request that continues the same game reuses the tree searched for it, including while pondering
+ */
+template <unsigned int SIDE_LENGTH>
+class Ponderer {
+public:
+	/**
+	 * @brief Constructs a search using the settings passed to the microservice
+	 */
+	Ponderer() : mcts(5000) {
+		mcts.setThreads(std::thread::hardware_concurrency());
+		mcts.setParallelMode(parallelMode);
+		mcts.setRaveEquivalence(raveEquivalence);
+		mcts.setEarlyStopping(earlyStopping);
+		mcts.setTranspositionTableSize(transpositionTableSize);
+		mcts.setNodeLimit(nodeLimit);
+	}
+
+	//Prevents copying/moving since the pondering thread points to the search
+	Ponderer(const Ponderer& other) = delete;
+	Ponderer& operator=(const Ponderer& other) = delete;
+	Ponderer(const Ponderer&& other) = delete;
+	Ponderer& operator=(const Ponderer&& other) = delete;
+
+	/**
+	 * @brief Stops pondering
+	 */
+	~Ponderer() {
+		stopPondering();
+	}
+
+	/**
+	 * @brief Picks the best move, continuing from the kept tree if the game state is one of the replies it searched, then starts pondering on the game state after the move if pondering is on
+	 * @param color color of current player
+	 * @param board current board state
+	 * @param previousBoards list of previous board states
+	 * @return best move
+	 */
+	int getBestMove(const char color, const std::string& board, const std::vector<std::string>& previousBoards) {
+		stopPondering();
+
+		GameState<SIDE_LENGTH>* current = findReply(color, board, previousBoards);
+		if (current == nullptr) {
+			//Starts over since the request does not continue the game searched so far
+			mcts.reset();
+			pool.reset();
+			gameState = nullptr;
+			current = GameState<SIDE_LENGTH>::newGame(color, board, previousBoards, &pool);
+		}
+
+		const unsigned int bestMove = mcts.getBestMove(current, timeLimit, simulationLimit);
+		const int move = current->getValidMoves()->at(bestMove);
+		std::cerr << "Picked move " << move << " after searching " << mcts.getStats() << '\n';
+
+		//Keeps the subtree of the move played, which holds the opponent's replies
+		gameState = current->getChild(bestMove, false);
+		delete current;
+		mcts.advance(bestMove);
+
+		if (ponder && gameState->getEndState() < -1) {
+			thread = std::thread([this] {
+				mcts.getBestMove(gameState, std::chrono::milliseconds(0), PONDER_SIMULATIONS);
+			});
+		}
+
+		return move;
+	}
+private:
+	/**
+	 * @brief Looks for the given game state among the replies to the kept game state, making it the root of the kept tree if found
+	 * @param color color of current player
+	 * @param board current board state
+	 * @param previousBoards list of previous board states
+	 * @return the reply, which is no longer owned by the kept game state, or null if not found
+	 */
+	GameState<SIDE_LENGTH>* findReply(const char color, const std::string& board, const std::vector<std::string>& previousBoards) {
+		if (gameState == nullptr || color == gameState->getColor()) {
+			return nullptr;
+		}
+
+		//The reply adds one piece of the kept game state's player on a cell that was empty, or leaves the board as it was if they passed
+		const Position<SIDE_LENGTH> position = Position<SIDE_LENGTH>::fromString(board);
+		const Position<SIDE_LENGTH>* kept = gameState->getPosition();
+		const Bitboard<SIDE_LENGTH> placed = (gameState->getColor() == 'X' ? position.black : position.white) & kept->empty();
+		int move;
+		if (placed.count() == 1) {
+			move = static_cast<int>(placed.lowest());
+		} else if (placed.none() && position.hash() == kept->hash()) {
+			move = -1;
+		} else {
+			return nullptr;
+		}
+
+		const std::pmr::vector<int>* validMoves = gameState->getValidMoves();
+		const auto found = std::find(validMoves->begin(), validMoves->end(), move);
+		if (found == validMoves->end()) {
+			return nullptr;
+		}
+		const auto index = static_cast<unsigned int>(found - validMoves->begin());
+
+		//Captures are checked by the hash, and the previous boards have to match too since they decide which moves superko bans
+		const GameState<SIDE_LENGTH>* reply = gameState->getChild(index);
+		if (reply->getHash() != position.hash() || reply->getPreviousBoards() != previousBoards) {
+			return nullptr;
+		}
+
+		GameState<SIDE_LENGTH>* child = gameState->getChild(index, false);
+		delete gameState;
+		gameState = nullptr;
+		mcts.advance(index);
+		return child;
+	}
+
+	/**
+	 * @brief Stops the pondering thread if it is running and waits for it to finish
+	 */
+	void stopPondering() {
+		if (!thread.joinable()) {
+			return;
+		}
+
+		mcts.setStopped(true);
+		thread.join();
+		mcts.setStopped(false);
+	}
+
+	/**
+	 * @brief Pool the kept game states are allocated from
+	 */
+	GameStatePool<SIDE_LENGTH> pool;
+	/**
+	 * @brief Search kept between requests
+	 */
+	BasicMCTS<SIDE_LENGTH> mcts;
+	/**
+	 * @brief Game state after the last move picked, or null if there is none
+	 */
+	GameState<SIDE_LENGTH>* gameState = nullptr;
+	/**
+	 * @brief Thread pondering on the kept game state
+	 */
+	std::thread thread;
+};
+
+/**
+ * @brief Picks the best move for a game with the given side length
+ * @param color color of current player
+ * @param board current board state
+ * @param previousBoards list of previous board states
+ * @return best move
+ */
+template <unsigned int SIDE_LENGTH>
+int getBestMove(const char color, const std::string& board, const std::vector<std::string>& previousBoards) {
+	static Ponderer<SIDE_LENGTH> ponderer;
+	return ponderer.getBestMove(color, board, previousBoards);
+}
+
+int main(int argc, char* argv[]) {
+	if (argc >= 2) {
+		timeLimit = std::chrono::milliseconds(std::stoi(argv[1]));
+	}
+	if (argc >= 3) {
+		simulationLimit = std::stoi(argv[2]);
+	}
+	if (argc >= 4) {
+		const std::string mode = argv[3];
+		if (mode == "root") {
+			parallelMode = ParallelMode::ROOT;
+		} else if (mode == "leaf") {
+			parallelMode = ParallelMode::LEAF;
+		} else if (mode != "tree") {
+			throw std::invalid_argument("Parallel mode must be tree, root or leaf");
+		}
+	}
+	if (argc >= 5) {
+		ponder = std::stoi(argv[4]) != 0;
+	}
+	if (argc >= 6) {
+		raveEquivalence = std::stoi(argv[5]);
+	}
+	if (argc >= 7) {
+		nodeLimit = std::stoull(argv[6]);
+	}
+	if (argc >= 8) {
+		earlyStopping = std::stoi(argv[7]) != 0;
+	}
+	if (argc >= 9) {
+		transpositionTableSize = std::stoul(argv[8]);
+	}
 
-int main() {
 	auto const address = net::ip::make_address("0.0.0.0");
 	constexpr unsigned short port = 8080;
 
 	net::io_context ioc{1};
 	std::make_shared<Listener>(ioc, tcp::endpoint{address, port}, [](const std::string& request) {
 		try {
-			MCTS mcts(5000);
-
 			std::vector<std::string> requestParts = split(request, ',');
 			const char color = requestParts.at(0).at(0);
 			const std::string& board = requestParts.at(1);
@@ -21,18 +252,30 @@ int main() {
 			if (requestParts.size() > 2) {
 				previousBoards = {requestParts.begin() + 2, requestParts.end()};
 			}
-			
-			GameState* gameState = GameState::newGame(color, board, previousBoards);
 
-			std::string response = std::to_string(gameState->getValidMoves()->at(mcts.getBestMove(gameState)));
-
-			delete gameState;
+			int move;
+			switch (static_cast<unsigned int>(std::lround(std::sqrt(board.size())))) {
+				case 5:
+					move = getBestMove<5>(color, board, previousBoards);
+					break;
+				case 7:
+					move = getBestMove<7>(color, board, previousBoards);
+					break;
+				case 9:
+					move = getBestMove<9>(color, board, previousBoards);
+					break;
+				case 13:
+					move = getBestMove<13>(color, board, previousBoards);
+					break;
+				default:
+					throw std::invalid_argument("Unsupported board size");
+			}
 
-			return response;
+			return std::to_string(move);
 		} catch (std::exception& e) {
-			std::cout << "Request body formatted incorrectly." << '\n';
-			std::cout << "Request: " << request << '\n';
-			std::cout << "Exception: " << e.what() << '\n';
+			std::cerr << "Request body formatted incorrectly." << '\n';
+			std::cerr << "Request: " << request << '\n';
+			std::cerr << "Exception: " << e.what() << '\n';
 
 			return std::string("Request body formatted incorrectly.");
 		}
@@ -0,0 +1,275 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "game/GameState.h"
+#include "game/GameStatePool.h"
+#include "game/RolloutBoard.h"
+
+/**
+ * @brief Position with a known number of leaf nodes at a given depth, used to catch rule changes
+ */
+struct PerftCase {
+	/**
+	 * @brief Description of the position
+	 */
+	const char* name;
+	/**
+	 * @brief Side length of the board
+	 */
+	unsigned int sideLength;
+	/**
+	 * @brief Color of the player to move
+	 */
+	char color;
+	/**
+	 * @brief Game board
+	 */
+	const char* board;
+	/**
+	 * @brief Depth to count to
+	 */
+	unsigned int depth;
+	/**
+	 * @brief Expected number of leaf nodes
+	 */
+	uint64_t nodes;
+};
+
+/**
+ * @brief Positions checked on every run, with counts that include passes and stop at finished games
+ */
+const std::vector<PerftCase> PERFT_CASES = {
+	{"Empty 5x5", 5, 'X', ".........................", 4, 361067},
+	{"Console start", 5, 'X', "#...#.....#.O...........#", 4, 143599},
+	{"Ko and suicide", 5, 'O', ".XO..X.XO..XO............", 4, 84814},
+	{"Walled 7x7", 7, 'O', "#.....#..X.O.....#.......O.X.....#......X...#...#", 3, 54689},
+	{"Empty 9x9", 9, 'X', ".................................................................................", 3, 531523},
+	{"Empty 13x13", 13, 'X', ".........................................................................................................................................................................", 2, 28731},
+};
+
+/**
+ * @brief Returns seconds passed since the given time
+ * @param begin time to measure from
+ * @return seconds passed
+ */
+double secondsSince(const std::chrono::steady_clock::time_point begin) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+/**
+ * @brief Counts the leaf nodes of the game tree to the given depth using game states
+ * @param gameState game state to count from
+ * @param depth number of moves to look ahead
+ * @return number of leaf nodes
+ */
+template <unsigned int SIDE_LENGTH>
+uint64_t perft(GameState<SIDE_LENGTH>* gameState, const unsigned int depth) {
+	if (depth == 0 || gameState->getEndState() >= -1) {
+		return 1;
+	}
+
+	uint64_t nodes = 0;
+	for (unsigned int i = 0; i < gameState->getValidMoves()->size(); i++) {
+		GameState<SIDE_LENGTH>* child = gameState->getChild(i, false);
+		nodes += perft(child, depth - 1);
+		delete child;
+	}
+
+	return nodes;
+}
+
+/**
+ * @brief Counts the leaf nodes of the game tree to the given depth by playing and undoing moves on a rollout board
+ * @param board rollout board to count from
+ * @param depth number of moves to look ahead
+ * @return number of leaf nodes
+ */
+template <unsigned int SIDE_LENGTH>
+uint64_t perft(RolloutBoard<SIDE_LENGTH>& board, const unsigned int depth) {
+	if (depth == 0 || board.isOver()) {
+		return 1;
+	}
+
+	uint64_t nodes = 0;
+	for (int move = -1; move < static_cast<int>(AREA<SIDE_LENGTH>); move++) {
+		if (board.isValid(move)) {
+			board.play(move);
+			nodes += perft(board, depth - 1);
+			board.undo();
+		}
+	}
+
+	return nodes;
+}
+
+/**
+ * @brief Counts the leaf nodes from a board with both engines and prints the results
+ * @param name description of the position
+ * @param color color of the player to move
+ * @param board game board
+ * @param depth number of moves to look ahead
+ * @param expected expected number of leaf nodes or 0 if unknown
+ * @return whether both engines agree with each other and the expected count
+ */
+template <unsigned int SIDE_LENGTH>
+bool runPerft(const std::string& name, const char color, const std::string& board, const unsigned int depth, const uint64_t expected) {
+	GameStatePool<SIDE_LENGTH> pool;
+	GameState<SIDE_LENGTH>* gameState = GameState<SIDE_LENGTH>::newGame(color, board, {}, &pool);
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	const uint64_t nodes = perft(gameState, depth);
+	const double gameStateSeconds = secondsSince(begin);
+
+	RolloutBoard<SIDE_LENGTH> rolloutBoard(gameState);
+	begin = std::chrono::steady_clock::now();
+	const uint64_t rolloutNodes = perft(rolloutBoard, depth);
+	const double rolloutSeconds = secondsSince(begin);
+
+	const bool passed = nodes == rolloutNodes && (expected == 0 || nodes == expected);
+	std::cout << std::left << std::setw(16) << name
+			  << " depth " << depth
+			  << std::right << std::setw(12) << nodes
+			  << std::setw(14) << static_cast<uint64_t>(static_cast<double>(nodes) / gameStateSeconds) << " n/s"
+			  << std::setw(14) << static_cast<uint64_t>(static_cast<double>(rolloutNodes) / rolloutSeconds) << " n/s rollout";
+	if (!passed) {
+		std::cout << "  MISMATCH rollout " << rolloutNodes << " expected " << expected;
+	}
+	std::cout << '\n';
+
+	return passed;
+}
+
+/**
+ * @brief Times the engine's core operations on positions reached by random games and prints operations per second
+ * @param samples number of positions to time
+ * @param seed seed for the random games
+ */
+template <unsigned int SIDE_LENGTH>
+void runBenchmark(const unsigned int samples, const uint64_t seed) {
+	std::mt19937_64 rng(seed);
+	GameStatePool<SIDE_LENGTH> pool;
+
+	//Collects positions from random games on random boards
+	std::vector<GameState<SIDE_LENGTH>*> gameStates;
+	while (gameStates.size() < samples) {
+		GameState<SIDE_LENGTH>* gameState = GameState<SIDE_LENGTH>::newGame('X', GameState<SIDE_LENGTH>::getRandomBoard(rng), {}, &pool);
+		while (gameState->getEndState() < -1 && gameStates.size() < samples) {
+			gameStates.emplace_back(gameState);
+			std::uniform_int_distribution<unsigned int> distribution(0, static_cast<unsigned int>(gameState->getValidMoves()->size() - 1));
+			gameState = gameState->getChild(distribution(rng));
+		}
+	}
+
+	//getValidMoves is timed on fresh copies so the moves are generated each time
+	std::vector<GameState<SIDE_LENGTH>*> copies;
+	copies.reserve(gameStates.size());
+	for (const GameState<SIDE_LENGTH>* gameState : gameStates) {
+		copies.emplace_back(gameState->copy(&pool));
+	}
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	uint64_t validMoves = 0;
+	for (GameState<SIDE_LENGTH>* copy : copies) {
+		validMoves += copy->getValidMoves()->size();
+	}
+	const double validMovesSeconds = secondsSince(begin);
+
+	begin = std::chrono::steady_clock::now();
+	uint64_t children = 0;
+	for (GameState<SIDE_LENGTH>* copy : copies) {
+		for (unsigned int i = 0; i < copy->getValidMoves()->size(); i++) {
+			copy->getChild(i);
+			children++;
+		}
+	}
+	const double childrenSeconds = secondsSince(begin);
+
+	//Placing pieces is timed through the rollout board, which plays moves in place
+	begin = std::chrono::steady_clock::now();
+	uint64_t placements = 0;
+	for (const GameState<SIDE_LENGTH>* gameState : gameStates) {
+		RolloutBoard<SIDE_LENGTH> board(gameState);
+		for (int move = -1; move < static_cast<int>(AREA<SIDE_LENGTH>); move++) {
+			if (board.isValid(move)) {
+				board.play(move);
+				board.undo();
+				placements++;
+			}
+		}
+	}
+	const double placementsSeconds = secondsSince(begin);
+
+	//Scoring is timed through Position::score, which endGame uses
+	begin = std::chrono::steady_clock::now();
+	float scoreTotal = 0;
+	for (const GameState<SIDE_LENGTH>* gameState : gameStates) {
+		scoreTotal += gameState->getPosition()->score();
+	}
+	const double scoresSeconds = secondsSince(begin);
+
+	std::cout << SIDE_LENGTH << 'x' << SIDE_LENGTH << " benchmark over " << gameStates.size() << " positions (score total " << scoreTotal << ")" << '\n';
+	std::cout << "  getValidMoves " << std::setw(14) << static_cast<uint64_t>(static_cast<double>(copies.size()) / validMovesSeconds) << " states/s, " << validMoves << " moves" << '\n';
+	std::cout << "  getChild      " << std::setw(14) << static_cast<uint64_t>(static_cast<double>(children) / childrenSeconds) << " children/s" << '\n';
+	std::cout << "  placePiece    " << std::setw(14) << static_cast<uint64_t>(static_cast<double>(placements) / placementsSeconds) << " plays/s" << '\n';
+	std::cout << "  endGame       " << std::setw(14) << static_cast<uint64_t>(static_cast<double>(gameStates.size()) / scoresSeconds) << " scores/s" << '\n';
+}
+
+/**
+ * @brief Counts a random board's game tree with both engines, which must agree
+ * @param rng random number generator used to make the board
+ * @param depth number of moves to look ahead
+ * @return whether both engines agree
+ */
+template <unsigned int SIDE_LENGTH>
+bool runRandomPerft(std::mt19937_64& rng, const unsigned int depth) {
+	const std::string board = GameState<SIDE_LENGTH>::getRandomBoard(rng);
+	return runPerft<SIDE_LENGTH>("Random " + std::to_string(SIDE_LENGTH) + 'x' + std::to_string(SIDE_LENGTH), 'X', board, depth, 0);
+}
+
+int main(int argc, char* argv[]) {
+	const unsigned int randomDepth = argc >= 2 ? std::stoi(argv[1]) : 3;
+	const uint64_t seed = argc >= 3 ? std::stoull(argv[2]) : 0;
+	const unsigned int samples = argc >= 4 ? std::stoi(argv[3]) : 20000;
+
+	bool passed = true;
+	for (const PerftCase& perftCase : PERFT_CASES) {
+		switch (perftCase.sideLength) {
+			case 5:
+				passed &= runPerft<5>(perftCase.name, perftCase.color, perftCase.board, perftCase.depth, perftCase.nodes);
+				break;
+			case 7:
+				passed &= runPerft<7>(perftCase.name, perftCase.color, perftCase.board, perftCase.depth, perftCase.nodes);
+				break;
+			case 9:
+				passed &= runPerft<9>(perftCase.name, perftCase.color, perftCase.board, perftCase.depth, perftCase.nodes);
+				break;
+			case 13:
+				passed &= runPerft<13>(perftCase.name, perftCase.color, perftCase.board, perftCase.depth, perftCase.nodes);
+				break;
+			default:
+				break;
+		}
+	}
+
+	//Random boards depend on the standard library's distributions, so they are only checked between engines
+	std::mt19937_64 rng(seed);
+	for (int i = 0; i < 4; i++) {
+		passed &= runRandomPerft<5>(rng, randomDepth + 1);
+	}
+	passed &= runRandomPerft<7>(rng, randomDepth);
+	passed &= runRandomPerft<9>(rng, randomDepth);
+	passed &= runRandomPerft<13>(rng, randomDepth > 1 ? randomDepth - 1 : 1);
+
+	std::cout << '\n';
+	runBenchmark<5>(samples, seed);
+	runBenchmark<9>(samples, seed);
+	runBenchmark<13>(samples / 4, seed);
+
+	std::cout << '\n' << (passed ? "All perft counts match." : "ERROR: Perft counts do not match.") << '\n';
+
+	return passed ? 0 : 1;
+}
@@ -8,10 +8,17 @@
 #include "ai/MCTS.h"
 #include "ai/Example.h"
 
-int main(int argc, char* argv[]) {
-	NeuralNetwork neuralNetwork;
-	std::ofstream lout("trainerLog.txt", std::ios::app);
-	lout << "Starting up" << '\n';
+/**
+ * @brief Generates examples through self play and trains a neural network on them for boards with the given side length
+ * @param argc number of command line arguments
+ * @param argv command line arguments
+ * @param config values loaded from the config file
+ * @param lout stream to log to
+ * @return exit code
+ */
+template <unsigned int SIDE_LENGTH>
+int runTrainer(const int argc, char* argv[], const std::vector<int>& config, std::ofstream& lout) {
+	NeuralNetwork<SIDE_LENGTH> neuralNetwork;
 	if (argc >= 2) {
 		if (!neuralNetwork.load(argv[1])) {
 			lout << "ERROR: Starting current model did not load correctly from " << argv[1] << '\n';
@@ -19,29 +26,7 @@ int main(int argc, char* argv[]) {
 	} else {
 		lout << "WARNING: No model was passed." << '\n';
 	}
-	
-	std::ifstream fin("config.txt");
-	
-	if (fin.fail()) {
-		lout << "FATAL: Config file did not load correctly" << '\n';
-		return 1;
-	}
-	
-	std::vector<int> config;
-	int iTemp;
-	for (int i = 0; i < 11; i++) {
-		fin >> iTemp;
-		
-		if (fin.fail()) {
-			lout << "FATAL: Config file did not load correctly" << '\n';
-			return 1;
-		}
-		
-		config.push_back(iTemp);
-		fin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-	}
-	fin.close();
-	
+
 	const int NUM_ITERATIONS = config.at(0);
 	const int NUM_EPISODES = config.at(1);
 	const int NUM_SIMULATIONS = config.at(2);
@@ -53,11 +38,28 @@ int main(int argc, char* argv[]) {
 	const int DISPLAY_GAMES = config.at(8);
 	const int MAXIMUM_TURNS = config.at(9);
 	const float RESULT_WEIGHT = config.at(10) / 100.0f;
-
+	const int SEARCH_THREADS = config.at(12);
+	const int SEARCH_BATCH_SIZE = config.at(13);
+	const int TRANSPOSITION_TABLE_SIZE = config.at(14);
+	const int EARLY_STOPPING = config.at(15);
+	const int EVALUATION_CACHE_SIZE = config.at(16);
+	const int NODE_LIMIT = config.at(17);
+	const int SEED = config.at(18);
+
+	//Every random number of the run comes from one root seed, drawn from the random device unless the config sets one
 	std::random_device seeder;
-	auto rng = std::mt19937_64(seeder());
+	auto rng = std::mt19937_64(SEED != 0 ? static_cast<uint64_t>(SEED) : seeder());
 	std::uniform_real_distribution distribution(0.0, 1.0);
-	AdvancedMCTS mcts(&neuralNetwork, NUM_SIMULATIONS);
+	std::ifstream fin;
+	neuralNetwork.setCacheSize(EVALUATION_CACHE_SIZE);
+	neuralNetwork.setSeed(rng());
+	AdvancedMCTS<SIDE_LENGTH> mcts(&neuralNetwork, NUM_SIMULATIONS);
+	mcts.setThreads(SEARCH_THREADS);
+	mcts.setBatchSize(SEARCH_BATCH_SIZE);
+	mcts.setTranspositionTableSize(TRANSPOSITION_TABLE_SIZE);
+	mcts.setNodeLimit(NODE_LIMIT);
+	mcts.setSeed(rng());
+	GameStatePool<SIDE_LENGTH> pool;
 	for (int iteration = 0; iteration < NUM_ITERATIONS; iteration++) {
 		lout << "Starting iteration " << iteration << '\n';
 		lout.flush();
@@ -72,13 +74,17 @@ int main(int argc, char* argv[]) {
 			std::ofstream gmout("multiGameMCTSTemp.gm", std::ios::app);
 
 			for (int episode = 0; episode < NUM_EPISODES; episode++) {
-				GameState* curGameState = GameState::newGame('O', GameState::getRandomBoard(rng));
+				GameState<SIDE_LENGTH>* curGameState = GameState<SIDE_LENGTH>::newGame('O', GameState<SIDE_LENGTH>::getRandomBoard(rng), {}, &pool);
 				
 				int turns = 0;
+				SearchStats searchStats;
 				std::vector<float> probabilities;
 				std::vector<std::tuple<std::vector<uint8_t>, std::vector<float>, float>> turnInformation;
 				while (curGameState->getEndState() < -1) {
+					//Only stops early once moves are no longer sampled, since stopping keeps the most visited move but changes the other moves' probabilities
+					mcts.setEarlyStopping(EARLY_STOPPING != 0 && turns >= EXPLORATION_TURNS);
 					probabilities = mcts.getMoveProbabilities(curGameState);
+					searchStats += mcts.getStats();
 					
 					turnInformation.emplace_back(toVector(curGameState), probabilities, mcts.getMoveValue(curGameState));
 
@@ -107,10 +113,11 @@ int main(int argc, char* argv[]) {
 						moveNum = bestMove;
 					}
 					
-					GameState* child = curGameState->getChild(moveNum, false);
+					//Keeps the chosen child's subtree so the next search continues from it
+					GameState<SIDE_LENGTH>* child = curGameState->getChild(moveNum, false);
 					delete curGameState;
 					curGameState = child;
-					mcts.reset();
+					mcts.advance(moveNum);
 					turns++;
 				}
 				
@@ -130,13 +137,25 @@ int main(int argc, char* argv[]) {
 				gmout.flush();
 
 				lout << "Finished " << (episode + 1) << " episode(s) in " << std::chrono::duration_cast<std::chrono::minutes>(std::chrono::steady_clock::now()-begin).count() << " minutes." << '\n';
+				lout << "Searched " << searchStats << " over " << turns << " turns." << '\n';
+				if (EARLY_STOPPING != 0) {
+					lout << "Early stopping saved " << searchStats.simulationsSaved << " simulations over " << turns << " turns." << '\n';
+				}
 				lout.flush();
 
-				delete curGameState;
+				//Releases what is left of the game at once
+				mcts.reset();
+				pool.reset();
 			}
 
 			exout.close();
 			gmout.close();
+
+			//Counters start over whenever training clears the cache
+			if (neuralNetwork.getCache() != nullptr) {
+				const unsigned long long lookups = neuralNetwork.getCache()->getHits() + neuralNetwork.getCache()->getMisses();
+				lout << "Evaluation cache hit " << neuralNetwork.getCache()->getHits() << " of " << lookups << " lookups." << '\n';
+			}
 		}
 
 		if (!neuralNetwork.save("models/temp.pt")) {
@@ -184,4 +203,53 @@ int main(int argc, char* argv[]) {
 	}
 	
 	return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+	std::ofstream lout("trainerLog.txt", std::ios::app);
+	lout << "Starting up" << '\n';
+
+	std::ifstream fin("config.txt");
+	
+	if (fin.fail()) {
+		lout << "FATAL: Config file did not load correctly" << '\n';
+		return 1;
+	}
+	
+	std::vector<int> config;
+	int iTemp;
+	for (int i = 0; i < 12; i++) {
+		fin >> iTemp;
+		
+		if (fin.fail()) {
+			lout << "FATAL: Config file did not load correctly" << '\n';
+			return 1;
+		}
+		
+		config.push_back(iTemp);
+		fin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+	}
+
+	//Search threads, batch size, transposition table size, early stopping, evaluation cache size, node limit and seed were added later, so older config files search with one thread evaluating one leaf at a time without a transposition table, early stopping, evaluation cache or node limit, seeded from the random device
+	for (const int defaultValue : {1, 1, 0, 0, 0, 0, 0}) {
+		fin >> iTemp;
+		config.push_back(fin.fail() || iTemp < defaultValue ? defaultValue : iTemp);
+		fin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+	}
+	fin.close();
+
+	const int BOARD_SIZE = config.at(11);
+	switch (BOARD_SIZE) {
+		case 5:
+			return runTrainer<5>(argc, argv, config, lout);
+		case 7:
+			return runTrainer<7>(argc, argv, config, lout);
+		case 9:
+			return runTrainer<9>(argc, argv, config, lout);
+		case 13:
+			return runTrainer<13>(argc, argv, config, lout);
+		default:
+			lout << "FATAL: Board size " << BOARD_SIZE << " is not supported" << '\n';
+			return 1;
+	}
+}